@@ -269,6 +269,33 @@
 #  undef VANILLA_SP_SYNAPSE_KIND
 #undef VANILLA_SP_SUBNAMESPACE
 
+#define VANILLA_SP_SUBNAMESPACE     GaussTestBitSliced8
+#  define VANILLA_SP_CONFIG           VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONLY
+#  define VANILLA_SP_SYNAPSE_KIND     VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8
+#  include "vanillaHTM/VanillaSPGen.h"
+#  include "vanillaHTM/VanillaSPImpl.h"
+#  undef VANILLA_SP_CONFIG
+#  undef VANILLA_SP_SYNAPSE_KIND
+#undef VANILLA_SP_SUBNAMESPACE
+
+#define VANILLA_SP_SUBNAMESPACE     GaussOne7x7Test16
+#  define VANILLA_SP_CONFIG           VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONE_7x7
+#  define VANILLA_SP_SYNAPSE_KIND     VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED16
+#  include "vanillaHTM/VanillaSPGen.h"
+#  include "vanillaHTM/VanillaSPImpl.h"
+#  undef VANILLA_SP_CONFIG
+#  undef VANILLA_SP_SYNAPSE_KIND
+#undef VANILLA_SP_SUBNAMESPACE
+
+#define VANILLA_SP_SUBNAMESPACE     BoxGaussTest16
+#  define VANILLA_SP_CONFIG           VANILLA_SP_CONFIG_CONST_LOCAL_BOXGAUSS_ONLY
+#  define VANILLA_SP_SYNAPSE_KIND     VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED16
+#  include "vanillaHTM/VanillaSPGen.h"
+#  include "vanillaHTM/VanillaSPImpl.h"
+#  undef VANILLA_SP_CONFIG
+#  undef VANILLA_SP_SYNAPSE_KIND
+#undef VANILLA_SP_SUBNAMESPACE
+
 using namespace HTMATCH;
 
 #include "examples/SampleTools.h"
@@ -278,7 +305,7 @@ using namespace HTMATCH;
 template<class VanillaSPKind>
 static void _reportPerfTest(const FixedDigitEncoder& inputEncoder, size_t uThousandsOfEpochs = 1u)
 {
-    static const char* tConfigTitles[13u] = {
+    static const char* tConfigTitles[14u] = {
         "<unknown>",
         "Global inhib, noboost",                                                    // 1
         "Bucket inhib, noboost",                                                    // 2
@@ -292,12 +319,14 @@ static void _reportPerfTest(const FixedDigitEncoder& inputEncoder, size_t uThous
         "Local inhib, with boosting, gaussian filter test",                         // 10
         "Local inhib, with boosting, gaussian filter + 1-winner over 7x7",          // 11
         "Local inhib, with boosting, gaussian filter + enforced spacing 6.5",       // 12
+        "Local inhib, with boosting, box-cascade approx. of gaussian filter",       // 13
     };
-    static const char* tSynapseKindTitles[4u] = {
+    static const char* tSynapseKindTitles[5u] = {
         "<unknown>",
         "32b float",    // 1
         "16b FixPt",    // 2
         "8b FixPt",     // 3
+        "8b FixPt, bit-sliced",     // 4
     };
 
     static const size_t uQWordPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;
@@ -344,6 +373,9 @@ int main()
     _reportPerfTest<GaussTest32::VanillaSP>(inputEncoder, 20u);
     _reportPerfTest<GaussTest16::VanillaSP>(inputEncoder, 20u);
     _reportPerfTest<GaussTest8::VanillaSP>(inputEncoder, 20u);
+    _reportPerfTest<GaussTestBitSliced8::VanillaSP>(inputEncoder, 20u);
+    _reportPerfTest<GaussOne7x7Test16::VanillaSP>(inputEncoder, 20u);
+    _reportPerfTest<BoxGaussTest16::VanillaSP>(inputEncoder, 20u);
 
 /*
     _reportPerfTest<GlobalNoBoosting32::VanillaSP>(inputEncoder, 30u);
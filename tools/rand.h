@@ -74,7 +74,7 @@ public:
     }
 
     FORCE_INLINE static constexpr uint32 _fromZeroToExcl(uint32 uOverMax, uint32 uDraw) {
-        return uOverMax % uDraw;
+        return uDraw % uOverMax;
     }
     FORCE_INLINE static constexpr double _asDouble01(uint32 uDraw) {
         return double(uDraw) * (1.0 / 4294967296.0);
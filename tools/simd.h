@@ -0,0 +1,1125 @@
+/* -----------------------------------
+ * HTMATCH
+ * simd.h
+ * -----------------------------------
+ * Defines runtime-dispatched SIMD helpers: detection of the instruction sets supported by the running CPU, and a few
+ *   vectorized kernels selected accordingly (falling back to plain scalar versions whenever none is available).
+ * Note: kernels for a given instruction set are compiled in regardless of the compiler's default target (using per-function
+ *   target attributes on GCC and clang; MSVC allows intrinsics anywhere), so a single binary can run everywhere and still
+ *   use the best available path.
+ *
+ * Copyright 2019, Guillaume Mirey
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _HTMATCH_SIMD_H
+#define _HTMATCH_SIMD_H
+
+#include "system.h"
+#include "bittools.h"
+
+// Vectorized kernels are only ever considered on x64 targets for now
+//
+
+#if defined(HTMATCH_ARCH_x64)
+#  define HTMATCH_SIMD_x64
+#  if defined (_MSC_VER)
+#    include "intrin.h"
+#    include "immintrin.h"
+#    define HTMATCH_TARGET_AVX2
+#    define HTMATCH_TARGET_AVX512_VPOPCNTDQ
+#    if (_MSC_VER >= 1920)      // VPOPCNTDQ intrinsics are not known to earlier versions
+#      define HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ
+#    endif
+#  elif defined(__GNUC__) || defined(__clang__)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#    define HTMATCH_TARGET_AVX2                 __attribute__((target("avx2")))
+#    define HTMATCH_TARGET_AVX512_VPOPCNTDQ     __attribute__((target("avx512f,avx512vpopcntdq")))
+#    if defined(__clang__) || (__GNUC__ >= 7)   // VPOPCNTDQ intrinsics are not known to earlier versions
+#      define HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ
+#    endif
+#  else
+#    undef HTMATCH_SIMD_x64     // no known way of reaching the intrinsics there... scalar only.
+#  endif
+#endif
+
+namespace HTMATCH {
+
+    // Instruction set levels which are detected and used by HTMATCH kernels, in increasing order of preference
+    enum eSimdLevel {
+        k_eSimdLevel_None,                  // scalar code only (well... still using hardware popcount when available)
+        k_eSimdLevel_AVX2,                  // 256b integer vectors
+        k_eSimdLevel_AVX512_VPOPCNTDQ,      // 512b integer vectors, with their per-qword popcount instruction
+    };
+
+    // - - - - - - - - - - - - - - - - -
+    // CPU feature detection
+    // - - - - - - - - - - - - - - - - -
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // Queries CPUID for given leaf and subleaf, results ordered as eax, ebx, ecx, edx
+    inline void _cpuidQuery(uint32 uLeaf, uint32 uSubLeaf, uint32 tOutRegs[4]) {
+#  if defined (_MSC_VER)
+        int tRegs[4];
+        __cpuidex(tRegs, int(uLeaf), int(uSubLeaf));
+        for (u8fast uReg = 0u; uReg < 4u; uReg++)
+            tOutRegs[uReg] = uint32(tRegs[uReg]);
+#  else
+        unsigned int uA = 0u, uB = 0u, uC = 0u, uD = 0u;
+        if (!__get_cpuid_count(uLeaf, uSubLeaf, &uA, &uB, &uC, &uD))
+            uA = uB = uC = uD = 0u;
+        tOutRegs[0] = uint32(uA); tOutRegs[1] = uint32(uB); tOutRegs[2] = uint32(uC); tOutRegs[3] = uint32(uD);
+#  endif
+    }
+
+    // Reads the XCR0 register, telling which extended register states the OS does save and restore for us
+    inline uint64 _readXCR0() {
+#  if defined (_MSC_VER)
+        return uint64(_xgetbv(0));
+#  else
+        uint32 uLo, uHi;
+        __asm__ __volatile__ ("xgetbv" : "=a"(uLo), "=d"(uHi) : "c"(0u));
+        return (uint64(uHi) << 32u) | uint64(uLo);
+#  endif
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Computes the best supported SIMD level on the running CPU. Prefer 'getSimdLevel()' below, which caches the result.
+    inline eSimdLevel detectSimdLevel() {
+#if defined(HTMATCH_SIMD_x64)
+        uint32 tRegs[4];
+        _cpuidQuery(0u, 0u, tRegs);
+        uint32 uMaxLeaf = tRegs[0];
+        if (uMaxLeaf < 7u)
+            return k_eSimdLevel_None;
+        _cpuidQuery(1u, 0u, tRegs);
+        static const uint32 k_uOSXSaveBit = 1u << 27u;      // leaf 1, ecx
+        static const uint32 k_uAVXBit = 1u << 28u;          // leaf 1, ecx
+        if ((tRegs[2] & (k_uOSXSaveBit|k_uAVXBit)) != (k_uOSXSaveBit|k_uAVXBit))
+            return k_eSimdLevel_None;
+        uint64 uXCR0 = _readXCR0();
+        static const uint64 k_uXmmYmmStates = 0x06uLL;      // SSE and AVX states
+        static const uint64 k_uZmmStates = 0xE0uLL;         // opmask, upper halves of zmm0-15, and zmm16-31 states
+        if ((uXCR0 & k_uXmmYmmStates) != k_uXmmYmmStates)
+            return k_eSimdLevel_None;
+        _cpuidQuery(7u, 0u, tRegs);
+        static const uint32 k_uAVX2Bit = 1u << 5u;          // leaf 7, ebx
+        static const uint32 k_uAVX512FBit = 1u << 16u;      // leaf 7, ebx
+        static const uint32 k_uVPOPCNTDQBit = 1u << 14u;    // leaf 7, ecx
+        if (0u == (tRegs[1] & k_uAVX2Bit))
+            return k_eSimdLevel_None;
+#  if defined(HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ)
+        if ((tRegs[1] & k_uAVX512FBit) && (tRegs[2] & k_uVPOPCNTDQBit) && (uXCR0 & k_uZmmStates) == k_uZmmStates)
+            return k_eSimdLevel_AVX512_VPOPCNTDQ;
+#  else
+        HTMATCH_unused(k_uAVX512FBit); HTMATCH_unused(k_uVPOPCNTDQBit); HTMATCH_unused(k_uZmmStates);
+#  endif
+        return k_eSimdLevel_AVX2;
+#else
+        return k_eSimdLevel_None;
+#endif
+    }
+
+    // Returns the best supported SIMD level on the running CPU (detected once, on first call)
+    inline eSimdLevel getSimdLevel() {
+        static const eSimdLevel s_eDetectedLevel = detectSimdLevel();
+        return s_eDetectedLevel;
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // AND-then-popcount of a set of same-sized bitfield rows against a single bitfield mask
+    //   For each of the 'uRowCount' rows (each 'uQwordsPerRow' long, tightly packed one after the other starting at 'pRows'),
+    //   writes to pOutCounts[row] the number of bits set in both that row and 'pMask'.
+    // Note: Output count per row is expected to fit on 16b.
+    // - - - - - - - - - - - - - - - - -
+
+    typedef void (*AndCountSetBitsPerRowFunc)(const uint64* pRows, const uint64* pMask, size_t uQwordsPerRow,
+        size_t uRowCount, uint16* pOutCounts);
+
+    // Scalar version of the kernel, see above
+    inline void andCountSetBitsPerRow_scalar(const uint64* pRows, const uint64* pMask, size_t uQwordsPerRow,
+        size_t uRowCount, uint16* pOutCounts)
+    {
+        const uint64* pCurrentRowQword = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++) {
+            uint64 uCountOnThisRow = 0uLL;
+            for (const uint64 *pCurrentMaskQword = pMask, *pEndMask = pMask + uQwordsPerRow; pCurrentMaskQword < pEndMask;
+                    pCurrentMaskQword++, pCurrentRowQword++) {
+                uCountOnThisRow += countSetBits64((*pCurrentRowQword) & (*pCurrentMaskQword));
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the kernel, see above
+    //   uses the 'nibble lookup' method (vpshufb against a 16 entries table), accumulating per-byte counts over a few
+    //   vectors before horizontally summing them with vpsadbw.
+    //   @see "Faster Population Counts Using AVX2 Instructions", by Wojciech Mula, Nathan Kurz and Daniel Lemire.
+    HTMATCH_TARGET_AVX2 inline void andCountSetBitsPerRow_avx2(const uint64* pRows, const uint64* pMask,
+        size_t uQwordsPerRow, size_t uRowCount, uint16* pOutCounts)
+    {
+        const __m256i vLookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i vLowNibbles = _mm256_set1_epi8(0x0F);
+        const __m256i vZero = _mm256_setzero_si256();
+        const size_t uVectorizedQwords = uQwordsPerRow & ~size_t(3u);
+        static const u8fast k_uMaxVectorsBeforeSad = 31u; // per-byte counts are at most 8 per vector => 31 x 8 fits in 8b
+        const uint64* pCurrentRow = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++, pCurrentRow += uQwordsPerRow) {
+            __m256i vTotal = vZero;
+            __m256i vByteCounts = vZero;
+            u8fast uVectorsInByteCounts = 0u;
+            for (size_t uQword = 0u; uQword < uVectorizedQwords; uQword += 4u) {
+                __m256i vBits = _mm256_and_si256(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCurrentRow + uQword)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pMask + uQword)));
+                __m256i vLo = _mm256_and_si256(vBits, vLowNibbles);
+                __m256i vHi = _mm256_and_si256(_mm256_srli_epi16(vBits, 4), vLowNibbles);
+                vByteCounts = _mm256_add_epi8(vByteCounts,
+                    _mm256_add_epi8(_mm256_shuffle_epi8(vLookup, vLo), _mm256_shuffle_epi8(vLookup, vHi)));
+                if (++uVectorsInByteCounts == k_uMaxVectorsBeforeSad) {
+                    vTotal = _mm256_add_epi64(vTotal, _mm256_sad_epu8(vByteCounts, vZero));
+                    vByteCounts = vZero;
+                    uVectorsInByteCounts = 0u;
+                }
+            }
+            vTotal = _mm256_add_epi64(vTotal, _mm256_sad_epu8(vByteCounts, vZero));
+            uint64 uCountOnThisRow = uint64(_mm256_extract_epi64(vTotal, 0)) + uint64(_mm256_extract_epi64(vTotal, 1)) +
+                                     uint64(_mm256_extract_epi64(vTotal, 2)) + uint64(_mm256_extract_epi64(vTotal, 3));
+            for (size_t uQword = uVectorizedQwords; uQword < uQwordsPerRow; uQword++) {
+                uCountOnThisRow += countSetBits64(pCurrentRow[uQword] & pMask[uQword]);
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#  if defined(HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ)
+
+    // AVX-512 version of the kernel, see above
+    //   VPOPCNTDQ gives us per-qword counts directly, which we can accumulate as-is.
+    HTMATCH_TARGET_AVX512_VPOPCNTDQ inline void andCountSetBitsPerRow_avx512(const uint64* pRows, const uint64* pMask,
+        size_t uQwordsPerRow, size_t uRowCount, uint16* pOutCounts)
+    {
+        const size_t uVectorizedQwords = uQwordsPerRow & ~size_t(7u);
+        const uint64* pCurrentRow = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++, pCurrentRow += uQwordsPerRow) {
+            __m512i vTotal = _mm512_setzero_si512();
+            for (size_t uQword = 0u; uQword < uVectorizedQwords; uQword += 8u) {
+                __m512i vBits = _mm512_and_si512(_mm512_loadu_si512(pCurrentRow + uQword), _mm512_loadu_si512(pMask + uQword));
+                vTotal = _mm512_add_epi64(vTotal, _mm512_popcnt_epi64(vBits));
+            }
+            // (reducing through both 256b halves with zero-masked extracts: unmasked ones, as well as _mm512_reduce_add_epi64,
+            //   are built upon 'undefined' vectors which trigger spurious 'maybe-uninitialized' warnings on gcc)
+            __m256i vHalves = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(__mmask8(0xFFu), vTotal, 0),
+                _mm512_maskz_extracti64x4_epi64(__mmask8(0xFFu), vTotal, 1));
+            uint64 uCountOnThisRow = uint64(_mm256_extract_epi64(vHalves, 0)) + uint64(_mm256_extract_epi64(vHalves, 1)) +
+                                     uint64(_mm256_extract_epi64(vHalves, 2)) + uint64(_mm256_extract_epi64(vHalves, 3));
+            for (size_t uQword = uVectorizedQwords; uQword < uQwordsPerRow; uQword++) {
+                uCountOnThisRow += countSetBits64(pCurrentRow[uQword] & pMask[uQword]);
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#  endif // HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ
+
+#endif // HTMATCH_SIMD_x64
+
+    // - - - - - - - - - - - - - - - - -
+    // Gathered variant of the above 'AndCountSetBitsPerRow' kernel, for when most of the mask qwords are known to be zero
+    //   Caller provides the compacted list of the 'uGatheredCount' non-zero mask qwords: their offsets within a row in
+    //   'pQwordOffsets', and their values in 'pMaskQwords'. Only those qwords are then fetched from each row.
+    // - - - - - - - - - - - - - - - - -
+
+    typedef void (*AndCountSetBitsPerRowGatheredFunc)(const uint64* pRows, size_t uQwordsPerRow, size_t uRowCount,
+        const uint32* pQwordOffsets, const uint64* pMaskQwords, size_t uGatheredCount, uint16* pOutCounts);
+
+    // Scalar version of the gathered kernel, see above
+    inline void andCountSetBitsPerRowGathered_scalar(const uint64* pRows, size_t uQwordsPerRow, size_t uRowCount,
+        const uint32* pQwordOffsets, const uint64* pMaskQwords, size_t uGatheredCount, uint16* pOutCounts)
+    {
+        const uint64* pCurrentRow = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++, pCurrentRow += uQwordsPerRow) {
+            uint64 uCountOnThisRow = 0uLL;
+            for (size_t uGathered = 0u; uGathered < uGatheredCount; uGathered++) {
+                uCountOnThisRow += countSetBits64(pCurrentRow[pQwordOffsets[uGathered]] & pMaskQwords[uGathered]);
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the gathered kernel, see above (same nibble-lookup count as 'andCountSetBitsPerRow_avx2')
+    HTMATCH_TARGET_AVX2 inline void andCountSetBitsPerRowGathered_avx2(const uint64* pRows, size_t uQwordsPerRow,
+        size_t uRowCount, const uint32* pQwordOffsets, const uint64* pMaskQwords, size_t uGatheredCount, uint16* pOutCounts)
+    {
+        const __m256i vLookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i vLowNibbles = _mm256_set1_epi8(0x0F);
+        const __m256i vZero = _mm256_setzero_si256();
+        const size_t uVectorizedCount = uGatheredCount & ~size_t(3u);
+        static const u8fast k_uMaxVectorsBeforeSad = 31u;
+        const uint64* pCurrentRow = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++, pCurrentRow += uQwordsPerRow) {
+            __m256i vTotal = vZero;
+            __m256i vByteCounts = vZero;
+            u8fast uVectorsInByteCounts = 0u;
+            const long long* pRowAsSigned = reinterpret_cast<const long long*>(pCurrentRow);
+            for (size_t uGathered = 0u; uGathered < uVectorizedCount; uGathered += 4u) {
+                __m128i vOffsets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pQwordOffsets + uGathered));
+                __m256i vBits = _mm256_and_si256(_mm256_i32gather_epi64(pRowAsSigned, vOffsets, 8),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pMaskQwords + uGathered)));
+                __m256i vLo = _mm256_and_si256(vBits, vLowNibbles);
+                __m256i vHi = _mm256_and_si256(_mm256_srli_epi16(vBits, 4), vLowNibbles);
+                vByteCounts = _mm256_add_epi8(vByteCounts,
+                    _mm256_add_epi8(_mm256_shuffle_epi8(vLookup, vLo), _mm256_shuffle_epi8(vLookup, vHi)));
+                if (++uVectorsInByteCounts == k_uMaxVectorsBeforeSad) {
+                    vTotal = _mm256_add_epi64(vTotal, _mm256_sad_epu8(vByteCounts, vZero));
+                    vByteCounts = vZero;
+                    uVectorsInByteCounts = 0u;
+                }
+            }
+            vTotal = _mm256_add_epi64(vTotal, _mm256_sad_epu8(vByteCounts, vZero));
+            uint64 uCountOnThisRow = uint64(_mm256_extract_epi64(vTotal, 0)) + uint64(_mm256_extract_epi64(vTotal, 1)) +
+                                     uint64(_mm256_extract_epi64(vTotal, 2)) + uint64(_mm256_extract_epi64(vTotal, 3));
+            for (size_t uGathered = uVectorizedCount; uGathered < uGatheredCount; uGathered++) {
+                uCountOnThisRow += countSetBits64(pCurrentRow[pQwordOffsets[uGathered]] & pMaskQwords[uGathered]);
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#  if defined(HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ)
+
+    // AVX-512 version of the gathered kernel, see above
+    HTMATCH_TARGET_AVX512_VPOPCNTDQ inline void andCountSetBitsPerRowGathered_avx512(const uint64* pRows,
+        size_t uQwordsPerRow, size_t uRowCount, const uint32* pQwordOffsets, const uint64* pMaskQwords,
+        size_t uGatheredCount, uint16* pOutCounts)
+    {
+        const size_t uVectorizedCount = uGatheredCount & ~size_t(7u);
+        const uint64* pCurrentRow = pRows;
+        for (uint16 *pCurrentOutput = pOutCounts, *pEndOutput = pOutCounts + uRowCount; pCurrentOutput < pEndOutput;
+                pCurrentOutput++, pCurrentRow += uQwordsPerRow) {
+            __m512i vTotal = _mm512_setzero_si512();
+            for (size_t uGathered = 0u; uGathered < uVectorizedCount; uGathered += 8u) {
+                __m256i vOffsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pQwordOffsets + uGathered));
+                // (masked gather from zero, for the same reason as the reduction below)
+                __m512i vBits = _mm512_and_si512(
+                    _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), __mmask8(0xFFu), vOffsets, pCurrentRow, 8),
+                    _mm512_loadu_si512(pMaskQwords + uGathered));
+                vTotal = _mm512_add_epi64(vTotal, _mm512_popcnt_epi64(vBits));
+            }
+            // (same reduction as above)
+            __m256i vHalves = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(__mmask8(0xFFu), vTotal, 0),
+                _mm512_maskz_extracti64x4_epi64(__mmask8(0xFFu), vTotal, 1));
+            uint64 uCountOnThisRow = uint64(_mm256_extract_epi64(vHalves, 0)) + uint64(_mm256_extract_epi64(vHalves, 1)) +
+                                     uint64(_mm256_extract_epi64(vHalves, 2)) + uint64(_mm256_extract_epi64(vHalves, 3));
+            for (size_t uGathered = uVectorizedCount; uGathered < uGatheredCount; uGathered++) {
+                uCountOnThisRow += countSetBits64(pCurrentRow[pQwordOffsets[uGathered]] & pMaskQwords[uGathered]);
+            }
+            *pCurrentOutput = uint16(uCountOnThisRow);
+        }
+    }
+
+#  endif // HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'andCountSetBitsPerRow' best suited to given SIMD level
+    inline AndCountSetBitsPerRowFunc getAndCountSetBitsPerRowFunc(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+#  if defined(HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ)
+        if (eLevel >= k_eSimdLevel_AVX512_VPOPCNTDQ)
+            return andCountSetBitsPerRow_avx512;
+#  endif
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return andCountSetBitsPerRow_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return andCountSetBitsPerRow_scalar;
+    }
+
+    // Returns the implementation of 'andCountSetBitsPerRow' best suited to the running CPU
+    inline AndCountSetBitsPerRowFunc getAndCountSetBitsPerRowFunc() {
+        return getAndCountSetBitsPerRowFunc(getSimdLevel());
+    }
+
+    // Returns the implementation of 'andCountSetBitsPerRowGathered' best suited to given SIMD level
+    inline AndCountSetBitsPerRowGatheredFunc getAndCountSetBitsPerRowGatheredFunc(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+#  if defined(HTMATCH_SIMD_HAS_AVX512_VPOPCNTDQ)
+        if (eLevel >= k_eSimdLevel_AVX512_VPOPCNTDQ)
+            return andCountSetBitsPerRowGathered_avx512;
+#  endif
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return andCountSetBitsPerRowGathered_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return andCountSetBitsPerRowGathered_scalar;
+    }
+
+    // Returns the implementation of 'andCountSetBitsPerRowGathered' best suited to the running CPU
+    inline AndCountSetBitsPerRowGatheredFunc getAndCountSetBitsPerRowGatheredFunc() {
+        return getAndCountSetBitsPerRowGatheredFunc(getSimdLevel());
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // Compare-and-compress of a set of values against a threshold
+    //   For each of the 'uCount' values (a multiple of 64) starting at 'pValues', which is strictly above 'uThreshold', writes
+    //   its index to the next slot of 'pOutIndices' (in increasing index order), and sets the corresponding bit in
+    //   'pOutBitmap' (bits are only ever set there, never cleared). Returns the number of indices written.
+    // Note: 'pOutIndices' shall be large enough for all values above threshold. Indices are expected to fit on 16b.
+    // - - - - - - - - - - - - - - - - -
+
+    typedef size_t (*CompressIndicesAbove16Func)(const uint16* pValues, size_t uCount, uint16 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap);
+    typedef size_t (*CompressIndicesAbove32Func)(const uint32* pValues, size_t uCount, uint32 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap);
+
+    // Common tail of all 'compressIndicesAbove' versions: merges the 64b mask of values above threshold starting at 'uBase'
+    //   into the bitmap, and appends their indices
+    FORCE_INLINE size_t _compressIndicesFromMask64(uint64 uMask, size_t uBase, uint16* pOutIndices,
+        uint64* pOutBitmap) FORCE_INLINE_END {
+        pOutBitmap[uBase >> 6u] |= uMask;
+        size_t uWritten = 0u;
+        while (uMask) {
+            pOutIndices[uWritten++] = uint16(uBase + getTrailingZeroesCount64(uMask));
+            uMask &= uMask - 1uLL;
+        }
+        return uWritten;
+    }
+
+    // Scalar version of the 16b kernel, see above
+    inline size_t compressIndicesAbove16_scalar(const uint16* pValues, size_t uCount, uint16 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap)
+    {
+        size_t uWritten = 0u;
+        for (size_t uBase = 0u; uBase < uCount; uBase += 64u) {
+            uint64 uMask = 0uLL;
+            for (u8fast uBit = 0u; uBit < 64u; uBit++) {
+                uMask |= uint64(pValues[uBase + uBit] > uThreshold) << uBit;
+            }
+            uWritten += _compressIndicesFromMask64(uMask, uBase, pOutIndices + uWritten, pOutBitmap);
+        }
+        return uWritten;
+    }
+
+    // Scalar version of the 32b kernel, see above
+    inline size_t compressIndicesAbove32_scalar(const uint32* pValues, size_t uCount, uint32 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap)
+    {
+        size_t uWritten = 0u;
+        for (size_t uBase = 0u; uBase < uCount; uBase += 64u) {
+            uint64 uMask = 0uLL;
+            for (u8fast uBit = 0u; uBit < 64u; uBit++) {
+                uMask |= uint64(pValues[uBase + uBit] > uThreshold) << uBit;
+            }
+            uWritten += _compressIndicesFromMask64(uMask, uBase, pOutIndices + uWritten, pOutBitmap);
+        }
+        return uWritten;
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the 16b kernel, see above
+    //   AVX2 only knows of signed compares: flipping the sign bit of both sides beforehand gives us the unsigned one.
+    //   Compare results are then packed to bytes so that a single movemask gets us 32 of them at once.
+    HTMATCH_TARGET_AVX2 inline size_t compressIndicesAbove16_avx2(const uint16* pValues, size_t uCount, uint16 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap)
+    {
+        const __m256i vSignBit = _mm256_set1_epi16(short(0x8000));
+        const __m256i vThreshold = _mm256_xor_si256(_mm256_set1_epi16(short(uThreshold)), vSignBit);
+        size_t uWritten = 0u;
+        for (size_t uBase = 0u; uBase < uCount; uBase += 64u) {
+            const __m256i* pVectors = reinterpret_cast<const __m256i*>(pValues + uBase);
+            __m256i vAbove0 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors), vSignBit), vThreshold);
+            __m256i vAbove1 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors + 1), vSignBit), vThreshold);
+            __m256i vAbove2 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors + 2), vSignBit), vThreshold);
+            __m256i vAbove3 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors + 3), vSignBit), vThreshold);
+            // packs work per 128b lane => qword permute restores index order
+            __m256i vLow = _mm256_permute4x64_epi64(_mm256_packs_epi16(vAbove0, vAbove1), 0xD8);
+            __m256i vHigh = _mm256_permute4x64_epi64(_mm256_packs_epi16(vAbove2, vAbove3), 0xD8);
+            uint64 uMask = uint64(uint32(_mm256_movemask_epi8(vLow))) | (uint64(uint32(_mm256_movemask_epi8(vHigh))) << 32u);
+            uWritten += _compressIndicesFromMask64(uMask, uBase, pOutIndices + uWritten, pOutBitmap);
+        }
+        return uWritten;
+    }
+
+    // AVX2 version of the 32b kernel, see above (same sign-flip trick as 'compressIndicesAbove16_avx2')
+    HTMATCH_TARGET_AVX2 inline size_t compressIndicesAbove32_avx2(const uint32* pValues, size_t uCount, uint32 uThreshold,
+        uint16* pOutIndices, uint64* pOutBitmap)
+    {
+        const __m256i vSignBit = _mm256_set1_epi32(int(0x80000000u));
+        const __m256i vThreshold = _mm256_xor_si256(_mm256_set1_epi32(int(uThreshold)), vSignBit);
+        size_t uWritten = 0u;
+        for (size_t uBase = 0u; uBase < uCount; uBase += 64u) {
+            const __m256i* pVectors = reinterpret_cast<const __m256i*>(pValues + uBase);
+            uint64 uMask = 0uLL;
+            for (u8fast uVector = 0u; uVector < 8u; uVector++) {
+                __m256i vAbove = _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_loadu_si256(pVectors + uVector), vSignBit),
+                    vThreshold);
+                uMask |= uint64(uint32(_mm256_movemask_ps(_mm256_castsi256_ps(vAbove)))) << (uVector * 8u);
+            }
+            uWritten += _compressIndicesFromMask64(uMask, uBase, pOutIndices + uWritten, pOutBitmap);
+        }
+        return uWritten;
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'compressIndicesAbove16' best suited to given SIMD level
+    inline CompressIndicesAbove16Func getCompressIndicesAbove16Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return compressIndicesAbove16_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return compressIndicesAbove16_scalar;
+    }
+
+    // Returns the implementation of 'compressIndicesAbove16' best suited to the running CPU
+    inline CompressIndicesAbove16Func getCompressIndicesAbove16Func() {
+        return getCompressIndicesAbove16Func(getSimdLevel());
+    }
+
+    // Returns the implementation of 'compressIndicesAbove32' best suited to given SIMD level
+    inline CompressIndicesAbove32Func getCompressIndicesAbove32Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return compressIndicesAbove32_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return compressIndicesAbove32_scalar;
+    }
+
+    // Returns the implementation of 'compressIndicesAbove32' best suited to the running CPU
+    inline CompressIndicesAbove32Func getCompressIndicesAbove32Func() {
+        return getCompressIndicesAbove32Func(getSimdLevel());
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // Compare of a short run of values against a threshold
+    //   Returns a mask with bit i set iff the value at 'pValues[i]' is strictly above 'uThreshold', for the 'uCount' values
+    //   (at most 32 of them) starting at 'pValues'.
+    // - - - - - - - - - - - - - - - - -
+
+    typedef uint32 (*MaskAbove16Func)(const uint16* pValues, size_t uCount, uint16 uThreshold);
+    typedef uint32 (*MaskAbove32Func)(const uint32* pValues, size_t uCount, uint32 uThreshold);
+
+    // Scalar version of the 16b kernel, see above
+    inline uint32 maskAbove16_scalar(const uint16* pValues, size_t uCount, uint16 uThreshold)
+    {
+        uint32 uMask = 0u;
+        for (size_t uIndex = 0u; uIndex < uCount; uIndex++) {
+            uMask |= uint32(pValues[uIndex] > uThreshold) << uIndex;
+        }
+        return uMask;
+    }
+
+    // Scalar version of the 32b kernel, see above
+    inline uint32 maskAbove32_scalar(const uint32* pValues, size_t uCount, uint32 uThreshold)
+    {
+        uint32 uMask = 0u;
+        for (size_t uIndex = 0u; uIndex < uCount; uIndex++) {
+            uMask |= uint32(pValues[uIndex] > uThreshold) << uIndex;
+        }
+        return uMask;
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the 16b kernel, see above (same sign-flip and pack tricks as 'compressIndicesAbove16_avx2').
+    //   Only runs of exactly one or two full vectors are vectorized ; others are left to the scalar version.
+    HTMATCH_TARGET_AVX2 inline uint32 maskAbove16_avx2(const uint16* pValues, size_t uCount, uint16 uThreshold)
+    {
+        if (uCount != 16u && uCount != 32u)
+            return maskAbove16_scalar(pValues, uCount, uThreshold);
+        const __m256i vSignBit = _mm256_set1_epi16(short(0x8000));
+        const __m256i vThreshold = _mm256_xor_si256(_mm256_set1_epi16(short(uThreshold)), vSignBit);
+        const __m256i* pVectors = reinterpret_cast<const __m256i*>(pValues);
+        __m256i vAbove0 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors), vSignBit), vThreshold);
+        __m256i vAbove1 = _mm256_setzero_si256();
+        if (uCount >= 32u)
+            vAbove1 = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_si256(pVectors + 1), vSignBit), vThreshold);
+        // packs work per 128b lane => qword permute restores index order
+        __m256i vPacked = _mm256_permute4x64_epi64(_mm256_packs_epi16(vAbove0, vAbove1), 0xD8);
+        return uint32(_mm256_movemask_epi8(vPacked));
+    }
+
+    // AVX2 version of the 32b kernel, see above (same sign-flip trick as 'compressIndicesAbove32_avx2')
+    HTMATCH_TARGET_AVX2 inline uint32 maskAbove32_avx2(const uint32* pValues, size_t uCount, uint32 uThreshold)
+    {
+        const __m256i vSignBit = _mm256_set1_epi32(int(0x80000000u));
+        const __m256i vThreshold = _mm256_xor_si256(_mm256_set1_epi32(int(uThreshold)), vSignBit);
+        const __m256i* pVectors = reinterpret_cast<const __m256i*>(pValues);
+        size_t uVectorCount = uCount >> 3u;
+        uint32 uMask = 0u;
+        for (size_t uVector = 0u; uVector < uVectorCount; uVector++) {
+            __m256i vAbove = _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_loadu_si256(pVectors + uVector), vSignBit),
+                vThreshold);
+            uMask |= uint32(_mm256_movemask_ps(_mm256_castsi256_ps(vAbove))) << (uVector * 8u);
+        }
+        size_t uDone = uVectorCount << 3u;
+        if (uDone < uCount)
+            uMask |= maskAbove32_scalar(pValues + uDone, uCount - uDone, uThreshold) << uDone;
+        return uMask;
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'maskAbove16' best suited to given SIMD level
+    inline MaskAbove16Func getMaskAbove16Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return maskAbove16_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return maskAbove16_scalar;
+    }
+
+    // Returns the implementation of 'maskAbove16' best suited to the running CPU
+    inline MaskAbove16Func getMaskAbove16Func() {
+        return getMaskAbove16Func(getSimdLevel());
+    }
+
+    // Returns the implementation of 'maskAbove32' best suited to given SIMD level
+    inline MaskAbove32Func getMaskAbove32Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return maskAbove32_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return maskAbove32_scalar;
+    }
+
+    // Returns the implementation of 'maskAbove32' best suited to the running CPU
+    inline MaskAbove32Func getMaskAbove32Func() {
+        return getMaskAbove32Func(getSimdLevel());
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // Wrapped-around convolutions of a set of lines by a 1D kernel, one way along the lines, one way across them
+    //   Lines are 'uLineCount' lines of 'uLineLength' values each (a multiple of 8), tightly packed one after the other
+    //   starting at 'pLines' ; the 'uTapCount' taps of the kernel (at most 'uLineLength' of them for the 'along' version, at
+    //   most 'uLineCount' for the 'across' one) are applied at relative offsets -uTapOrigin up to uTapCount-1-uTapOrigin:
+    //   along: out[line][i] = (sum over t of pTaps[t] * in[line][(i + t - uTapOrigin) mod uLineLength]) >> uShift
+    //   across: out[line][i] = (sum over t of pTaps[t] * in[(line + t - uTapOrigin) mod uLineCount][i]) >> uShift
+    //   All arithmetic is done on 32b unsigned values, modulo 2^32, so that all versions give the exact same results.
+    // Note: 'pTmpPaddedLine' shall have room for uLineLength + uTapCount - 1 values (used by 'along' versions only).
+    // - - - - - - - - - - - - - - - - -
+
+    typedef void (*ConvolveLinesWrappedFunc)(const uint32* pLines, size_t uLineLength, size_t uLineCount,
+        const uint32* pTaps, size_t uTapCount, size_t uTapOrigin, u8fast uShift, uint32* pTmpPaddedLine, uint32* pOutLines);
+
+    // Scalar version of the 'along' kernel, see above
+    inline void convolveAlongLinesWrapped_scalar(const uint32* pLines, size_t uLineLength, size_t uLineCount,
+        const uint32* pTaps, size_t uTapCount, size_t uTapOrigin, u8fast uShift, uint32* pTmpPaddedLine, uint32* pOutLines)
+    {
+        HTMATCH_unused(pTmpPaddedLine);
+        for (size_t uLine = 0u; uLine < uLineCount; uLine++) {
+            const uint32* pLine = pLines + uLine * uLineLength;
+            for (size_t uPos = 0u; uPos < uLineLength; uPos++, pOutLines++) {
+                uint32 uSum = 0u;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++) {
+                    uSum += pTaps[uTap] * pLine[(uPos + uTap + uLineLength - uTapOrigin) % uLineLength];
+                }
+                *pOutLines = uSum >> uShift;
+            }
+        }
+    }
+
+    // Scalar version of the 'across' kernel, see above
+    inline void convolveAcrossLinesWrapped_scalar(const uint32* pLines, size_t uLineLength, size_t uLineCount,
+        const uint32* pTaps, size_t uTapCount, size_t uTapOrigin, u8fast uShift, uint32* pTmpPaddedLine, uint32* pOutLines)
+    {
+        HTMATCH_unused(pTmpPaddedLine);
+        for (size_t uLine = 0u; uLine < uLineCount; uLine++) {
+            for (size_t uPos = 0u; uPos < uLineLength; uPos++, pOutLines++) {
+                uint32 uSum = 0u;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++) {
+                    uSum += pTaps[uTap] * pLines[((uLine + uTap + uLineCount - uTapOrigin) % uLineCount) * uLineLength + uPos];
+                }
+                *pOutLines = uSum >> uShift;
+            }
+        }
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the 'along' kernel, see above
+    //   Each line is first copied to 'pTmpPaddedLine' with its wrapped-around borders, once and for all, so that each tap
+    //   then turns to plain unaligned loads. Four vectors of 8 outputs are accumulated at once, for each broadcast tap.
+    HTMATCH_TARGET_AVX2 inline void convolveAlongLinesWrapped_avx2(const uint32* pLines, size_t uLineLength,
+        size_t uLineCount, const uint32* pTaps, size_t uTapCount, size_t uTapOrigin, u8fast uShift, uint32* pTmpPaddedLine,
+        uint32* pOutLines)
+    {
+        const __m128i vShift = _mm_cvtsi32_si128(int(uShift));
+        size_t uPaddedLength = uLineLength + uTapCount - 1u;
+        size_t uFirstSource = (uLineLength - uTapOrigin) % uLineLength;
+        for (size_t uLine = 0u; uLine < uLineCount; uLine++, pOutLines += uLineLength) {
+            const uint32* pLine = pLines + uLine * uLineLength;
+            for (size_t uPadded = 0u, uSource = uFirstSource; uPadded < uPaddedLength; uPadded++) {
+                pTmpPaddedLine[uPadded] = pLine[uSource];
+                if (++uSource == uLineLength)
+                    uSource = 0u;
+            }
+            size_t uPos = 0u;
+            for (; uPos + 32u <= uLineLength; uPos += 32u) {
+                __m256i vSum0 = _mm256_setzero_si256();
+                __m256i vSum1 = _mm256_setzero_si256();
+                __m256i vSum2 = _mm256_setzero_si256();
+                __m256i vSum3 = _mm256_setzero_si256();
+                const uint32* pSource = pTmpPaddedLine + uPos;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++, pSource++) {
+                    const __m256i vTap = _mm256_set1_epi32(int(pTaps[uTap]));
+                    const __m256i* pVectors = reinterpret_cast<const __m256i*>(pSource);
+                    vSum0 = _mm256_add_epi32(vSum0, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors)));
+                    vSum1 = _mm256_add_epi32(vSum1, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 1)));
+                    vSum2 = _mm256_add_epi32(vSum2, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 2)));
+                    vSum3 = _mm256_add_epi32(vSum3, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 3)));
+                }
+                __m256i* pOutVectors = reinterpret_cast<__m256i*>(pOutLines + uPos);
+                _mm256_storeu_si256(pOutVectors, _mm256_srl_epi32(vSum0, vShift));
+                _mm256_storeu_si256(pOutVectors + 1, _mm256_srl_epi32(vSum1, vShift));
+                _mm256_storeu_si256(pOutVectors + 2, _mm256_srl_epi32(vSum2, vShift));
+                _mm256_storeu_si256(pOutVectors + 3, _mm256_srl_epi32(vSum3, vShift));
+            }
+            for (; uPos < uLineLength; uPos += 8u) {
+                __m256i vSum = _mm256_setzero_si256();
+                const uint32* pSource = pTmpPaddedLine + uPos;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++, pSource++) {
+                    vSum = _mm256_add_epi32(vSum, _mm256_mullo_epi32(_mm256_set1_epi32(int(pTaps[uTap])),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSource))));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOutLines + uPos), _mm256_srl_epi32(vSum, vShift));
+            }
+        }
+    }
+
+    // AVX2 version of the 'across' kernel, see above
+    //   No padding required there: wrapping around is only a matter of choosing the source line for each tap. Four vectors
+    //   of 8 outputs are accumulated at once, for each broadcast tap.
+    HTMATCH_TARGET_AVX2 inline void convolveAcrossLinesWrapped_avx2(const uint32* pLines, size_t uLineLength,
+        size_t uLineCount, const uint32* pTaps, size_t uTapCount, size_t uTapOrigin, u8fast uShift, uint32* pTmpPaddedLine,
+        uint32* pOutLines)
+    {
+        HTMATCH_unused(pTmpPaddedLine);
+        const __m128i vShift = _mm_cvtsi32_si128(int(uShift));
+        size_t uFirstSourceLine = uLineCount - uTapOrigin;
+        for (size_t uLine = 0u; uLine < uLineCount; uLine++, pOutLines += uLineLength) {
+            size_t uPos = 0u;
+            for (; uPos + 32u <= uLineLength; uPos += 32u) {
+                __m256i vSum0 = _mm256_setzero_si256();
+                __m256i vSum1 = _mm256_setzero_si256();
+                __m256i vSum2 = _mm256_setzero_si256();
+                __m256i vSum3 = _mm256_setzero_si256();
+                size_t uSourceLine = (uLine + uFirstSourceLine) % uLineCount;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++) {
+                    const __m256i vTap = _mm256_set1_epi32(int(pTaps[uTap]));
+                    const __m256i* pVectors = reinterpret_cast<const __m256i*>(pLines + uSourceLine * uLineLength + uPos);
+                    vSum0 = _mm256_add_epi32(vSum0, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors)));
+                    vSum1 = _mm256_add_epi32(vSum1, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 1)));
+                    vSum2 = _mm256_add_epi32(vSum2, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 2)));
+                    vSum3 = _mm256_add_epi32(vSum3, _mm256_mullo_epi32(vTap, _mm256_loadu_si256(pVectors + 3)));
+                    if (++uSourceLine == uLineCount)
+                        uSourceLine = 0u;
+                }
+                __m256i* pOutVectors = reinterpret_cast<__m256i*>(pOutLines + uPos);
+                _mm256_storeu_si256(pOutVectors, _mm256_srl_epi32(vSum0, vShift));
+                _mm256_storeu_si256(pOutVectors + 1, _mm256_srl_epi32(vSum1, vShift));
+                _mm256_storeu_si256(pOutVectors + 2, _mm256_srl_epi32(vSum2, vShift));
+                _mm256_storeu_si256(pOutVectors + 3, _mm256_srl_epi32(vSum3, vShift));
+            }
+            for (; uPos < uLineLength; uPos += 8u) {
+                __m256i vSum = _mm256_setzero_si256();
+                size_t uSourceLine = (uLine + uFirstSourceLine) % uLineCount;
+                for (size_t uTap = 0u; uTap < uTapCount; uTap++) {
+                    vSum = _mm256_add_epi32(vSum, _mm256_mullo_epi32(_mm256_set1_epi32(int(pTaps[uTap])),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLines + uSourceLine * uLineLength + uPos))));
+                    if (++uSourceLine == uLineCount)
+                        uSourceLine = 0u;
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOutLines + uPos), _mm256_srl_epi32(vSum, vShift));
+            }
+        }
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'convolveAlongLinesWrapped' best suited to given SIMD level
+    inline ConvolveLinesWrappedFunc getConvolveAlongLinesWrappedFunc(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return convolveAlongLinesWrapped_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return convolveAlongLinesWrapped_scalar;
+    }
+
+    // Returns the implementation of 'convolveAlongLinesWrapped' best suited to the running CPU
+    inline ConvolveLinesWrappedFunc getConvolveAlongLinesWrappedFunc() {
+        return getConvolveAlongLinesWrappedFunc(getSimdLevel());
+    }
+
+    // Returns the implementation of 'convolveAcrossLinesWrapped' best suited to given SIMD level
+    inline ConvolveLinesWrappedFunc getConvolveAcrossLinesWrappedFunc(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return convolveAcrossLinesWrapped_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return convolveAcrossLinesWrapped_scalar;
+    }
+
+    // Returns the implementation of 'convolveAcrossLinesWrapped' best suited to the running CPU
+    inline ConvolveLinesWrappedFunc getConvolveAcrossLinesWrappedFunc() {
+        return getConvolveAcrossLinesWrappedFunc(getSimdLevel());
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // Hebbian update of a set of fixed-point synapse permanences towards a binary input
+    //   For each of the 'uCount' synapses, reads the bit of 'pInputBitmap' at the index found in 'pPreSynIndices', then
+    //   increases the permanence in 'pPermanences' by 'uIncrease' if that bit is set, or decreases it by 'uDecrease' otherwise,
+    //   saturating at both ends of the permanence type. Synapses whose permanence crosses 'uThreshold' (one way or the other)
+    //   get their bit set in 'pOutCrossings', which is fully overwritten, one qword per 64 synapses (or part thereof).
+    // - - - - - - - - - - - - - - - - -
+
+    typedef void (*UpdatePermanences16Func)(const uint16* pPreSynIndices, uint16* pPermanences, size_t uCount,
+        const uint64* pInputBitmap, uint16 uIncrease, uint16 uDecrease, uint16 uThreshold, uint64* pOutCrossings);
+    typedef void (*UpdatePermanences8Func)(const uint16* pPreSynIndices, uint8* pPermanences, size_t uCount,
+        const uint64* pInputBitmap, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold, uint64* pOutCrossings);
+
+    // Scalar version of the kernels, see above (shared by both permanence types, and by the tails of the vectorized ones).
+    //   Unbranching on input bit, as it is mostly unpredictable.
+    template<typename PermType>
+    inline void updatePermanences_scalar(const uint16* pPreSynIndices, PermType* pPermanences, size_t uCount,
+        const uint64* pInputBitmap, PermType uIncrease, PermType uDecrease, PermType uThreshold, uint64* pOutCrossings,
+        size_t uStart = 0u)
+    {
+        static const int32 k_iMax = int32(PermType(~PermType(0)));
+        for (size_t uQword = uStart >> 6u; uQword < ((uCount + 63u) >> 6u); uQword++)
+            pOutCrossings[uQword] = 0uLL;
+        for (size_t uSyn = uStart; uSyn < uCount; uSyn++) {
+            u16fast uPreSynIndex = pPreSynIndices[uSyn];
+            int32 iActive = int32((pInputBitmap[uPreSynIndex >> 6u] >> (uPreSynIndex & 0x3Fu)) & 1uLL);
+            int32 iPrevious = int32(pPermanences[uSyn]);
+            int32 iNow = iPrevious + iActive * int32(uIncrease) - (1 - iActive) * int32(uDecrease);
+            iNow = iNow < 0 ? 0 : (iNow > k_iMax ? k_iMax : iNow);
+            pPermanences[uSyn] = PermType(iNow);
+            uint64 uCrossed = uint64((iPrevious >= int32(uThreshold)) != (iNow >= int32(uThreshold)));
+            pOutCrossings[uSyn >> 6u] |= uCrossed << (uSyn & 0x3Fu);
+        }
+    }
+    inline void updatePermanences16_scalar(const uint16* pPreSynIndices, uint16* pPermanences, size_t uCount,
+        const uint64* pInputBitmap, uint16 uIncrease, uint16 uDecrease, uint16 uThreshold, uint64* pOutCrossings)
+    {
+        updatePermanences_scalar<uint16>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+            uThreshold, pOutCrossings);
+    }
+    inline void updatePermanences8_scalar(const uint16* pPreSynIndices, uint8* pPermanences, size_t uCount,
+        const uint64* pInputBitmap, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold, uint64* pOutCrossings)
+    {
+        updatePermanences_scalar<uint8>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+            uThreshold, pOutCrossings);
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // Gathers the input bits for 8 synapses, from their 8 presynaptic indices as 32b lanes, into 32b lanes of 0 or 1
+    //   (input bitfield is read as dwords, bit i being bit i%32 of dword i/32 in little endian)
+    HTMATCH_TARGET_AVX2 FORCE_INLINE __m256i _gatherInputBits8_avx2(__m256i vIndices, const int* pInputDwords) FORCE_INLINE_END
+    {
+        __m256i vDwords = _mm256_i32gather_epi32(pInputDwords, _mm256_srli_epi32(vIndices, 5), 4);
+        __m256i vShifts = _mm256_and_si256(vIndices, _mm256_set1_epi32(0x1F));
+        return _mm256_and_si256(_mm256_srlv_epi32(vDwords, vShifts), _mm256_set1_epi32(1));
+    }
+
+    // AVX2 version of the 16b kernel, see above: 16 synapses at a time, input bits gathered 8 at a time, then packed to 16b
+    //   lanes ; saturating add and sub, then select on input bit. Crossings are told by 'max(perm, threshold) == perm' (an
+    //   unsigned compare for being at or above threshold) differing before and after.
+    HTMATCH_TARGET_AVX2 inline void updatePermanences16_avx2(const uint16* pPreSynIndices, uint16* pPermanences,
+        size_t uCount, const uint64* pInputBitmap, uint16 uIncrease, uint16 uDecrease, uint16 uThreshold,
+        uint64* pOutCrossings)
+    {
+        const int* pInputDwords = reinterpret_cast<const int*>(pInputBitmap);
+        const __m256i vIncrease = _mm256_set1_epi16(short(uIncrease));
+        const __m256i vDecrease = _mm256_set1_epi16(short(uDecrease));
+        const __m256i vThreshold = _mm256_set1_epi16(short(uThreshold));
+        const __m256i vOne = _mm256_set1_epi16(1);
+        size_t uVectorized = uCount & ~size_t(15u);
+        for (size_t uSyn = 0u; uSyn < uVectorized; uSyn += 16u) {
+            __m256i vIndices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPreSynIndices + uSyn));
+            __m256i vBitsLo = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(vIndices)), pInputDwords);
+            __m256i vBitsHi = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(vIndices, 1)),
+                pInputDwords);
+            // packs work per 128b lane => qword permute restores synapse order
+            __m256i vBits = _mm256_permute4x64_epi64(_mm256_packus_epi32(vBitsLo, vBitsHi), 0xD8);
+            __m256i vActive = _mm256_cmpeq_epi16(vBits, vOne);
+            __m256i* pPermVector = reinterpret_cast<__m256i*>(pPermanences + uSyn);
+            __m256i vPrevious = _mm256_loadu_si256(pPermVector);
+            __m256i vNow = _mm256_blendv_epi8(_mm256_subs_epu16(vPrevious, vDecrease),
+                _mm256_adds_epu16(vPrevious, vIncrease), vActive);
+            _mm256_storeu_si256(pPermVector, vNow);
+            __m256i vWasAbove = _mm256_cmpeq_epi16(_mm256_max_epu16(vPrevious, vThreshold), vPrevious);
+            __m256i vIsAbove = _mm256_cmpeq_epi16(_mm256_max_epu16(vNow, vThreshold), vNow);
+            __m256i vCrossed = _mm256_xor_si256(vWasAbove, vIsAbove);
+            __m256i vCrossedBytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(vCrossed, vCrossed), 0xD8);
+            uint64 uCrossed = uint64(uint32(_mm256_movemask_epi8(vCrossedBytes)) & 0xFFFFu);
+            if (0u == (uSyn & 0x3Fu))
+                pOutCrossings[uSyn >> 6u] = 0uLL;
+            pOutCrossings[uSyn >> 6u] |= uCrossed << (uSyn & 0x3Fu);
+        }
+        if (uVectorized & 0x3Fu) {      // scalar tail would clear the qword we're in the middle of => saving it first
+            uint64 uPartial = pOutCrossings[uVectorized >> 6u];
+            updatePermanences_scalar<uint16>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+                uThreshold, pOutCrossings, uVectorized);
+            pOutCrossings[uVectorized >> 6u] |= uPartial;
+        } else {
+            updatePermanences_scalar<uint16>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+                uThreshold, pOutCrossings, uVectorized);
+        }
+    }
+
+    // AVX2 version of the 8b kernel, see above: same as the 16b one, with 32 synapses at a time, their input bits gathered
+    //   8 at a time, then packed to 8b lanes.
+    HTMATCH_TARGET_AVX2 inline void updatePermanences8_avx2(const uint16* pPreSynIndices, uint8* pPermanences,
+        size_t uCount, const uint64* pInputBitmap, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold,
+        uint64* pOutCrossings)
+    {
+        const int* pInputDwords = reinterpret_cast<const int*>(pInputBitmap);
+        const __m256i vIncrease = _mm256_set1_epi8(char(uIncrease));
+        const __m256i vDecrease = _mm256_set1_epi8(char(uDecrease));
+        const __m256i vThreshold = _mm256_set1_epi8(char(uThreshold));
+        const __m256i vOne = _mm256_set1_epi8(1);
+        // packs work per 128b lane => after both packs, dword j of the result holds synapses of dword vRestoreOrder[j]
+        const __m256i vRestoreOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t uVectorized = uCount & ~size_t(31u);
+        for (size_t uSyn = 0u; uSyn < uVectorized; uSyn += 32u) {
+            __m256i vIndices0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPreSynIndices + uSyn));
+            __m256i vIndices1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPreSynIndices + uSyn + 16u));
+            __m256i vBits0 = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(vIndices0)), pInputDwords);
+            __m256i vBits1 = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(vIndices0, 1)),
+                pInputDwords);
+            __m256i vBits2 = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(vIndices1)), pInputDwords);
+            __m256i vBits3 = _gatherInputBits8_avx2(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(vIndices1, 1)),
+                pInputDwords);
+            __m256i vBits = _mm256_packus_epi16(_mm256_packus_epi32(vBits0, vBits1), _mm256_packus_epi32(vBits2, vBits3));
+            vBits = _mm256_permutevar8x32_epi32(vBits, vRestoreOrder);
+            __m256i vActive = _mm256_cmpeq_epi8(vBits, vOne);
+            __m256i* pPermVector = reinterpret_cast<__m256i*>(pPermanences + uSyn);
+            __m256i vPrevious = _mm256_loadu_si256(pPermVector);
+            __m256i vNow = _mm256_blendv_epi8(_mm256_subs_epu8(vPrevious, vDecrease),
+                _mm256_adds_epu8(vPrevious, vIncrease), vActive);
+            _mm256_storeu_si256(pPermVector, vNow);
+            __m256i vWasAbove = _mm256_cmpeq_epi8(_mm256_max_epu8(vPrevious, vThreshold), vPrevious);
+            __m256i vIsAbove = _mm256_cmpeq_epi8(_mm256_max_epu8(vNow, vThreshold), vNow);
+            uint64 uCrossed = uint64(uint32(_mm256_movemask_epi8(_mm256_xor_si256(vWasAbove, vIsAbove))));
+            if (0u == (uSyn & 0x3Fu))
+                pOutCrossings[uSyn >> 6u] = 0uLL;
+            pOutCrossings[uSyn >> 6u] |= uCrossed << (uSyn & 0x3Fu);
+        }
+        if (uVectorized & 0x3Fu) {      // scalar tail would clear the qword we're in the middle of => saving it first
+            uint64 uPartial = pOutCrossings[uVectorized >> 6u];
+            updatePermanences_scalar<uint8>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+                uThreshold, pOutCrossings, uVectorized);
+            pOutCrossings[uVectorized >> 6u] |= uPartial;
+        } else {
+            updatePermanences_scalar<uint8>(pPreSynIndices, pPermanences, uCount, pInputBitmap, uIncrease, uDecrease,
+                uThreshold, pOutCrossings, uVectorized);
+        }
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'updatePermanences16' best suited to given SIMD level
+    inline UpdatePermanences16Func getUpdatePermanences16Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return updatePermanences16_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return updatePermanences16_scalar;
+    }
+
+    // Returns the implementation of 'updatePermanences16' best suited to the running CPU
+    inline UpdatePermanences16Func getUpdatePermanences16Func() {
+        return getUpdatePermanences16Func(getSimdLevel());
+    }
+
+    // Returns the implementation of 'updatePermanences8' best suited to given SIMD level
+    inline UpdatePermanences8Func getUpdatePermanences8Func(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return updatePermanences8_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return updatePermanences8_scalar;
+    }
+
+    // Returns the implementation of 'updatePermanences8' best suited to the running CPU
+    inline UpdatePermanences8Func getUpdatePermanences8Func() {
+        return getUpdatePermanences8Func(getSimdLevel());
+    }
+
+    // - - - - - - - - - - - - - - - - -
+    // Hebbian update of a set of 8b permanences stored as bitplanes
+    //   'pPlanes' holds 8 planes of 'uQwordCount' qwords each (lsb plane first), bit i of qword q in plane p being bit p of
+    //   permanence 64q+i. Adds 'uIncrease' to the permanences having their bit set in 'pIncreaseMasks', and subtracts
+    //   'uDecrease' from those having their bit set in 'pDecreaseMasks' (those two shall not overlap), saturating at both
+    //   ends. Then writes to 'pOutAtOrAbove' the mask of the permanences now at or above 'uThreshold', one qword per qword.
+    //   This is a single ripple-carry pass, plane by plane, the subtraction being performed as the addition of the two's
+    //   complement: a carry out of the last plane then tells there was no underflow.
+    // - - - - - - - - - - - - - - - - -
+
+    typedef void (*UpdateBitSlicedPermanencesFunc)(uint64* pPlanes, size_t uQwordCount, const uint64* pIncreaseMasks,
+        const uint64* pDecreaseMasks, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold, uint64* pOutAtOrAbove);
+
+    // Returns the mask of those among the 64 bit-sliced permanences found at 'pPlanes' (8 planes, 'uPlaneStride' qwords
+    //   apart, lsb first) which are at or above 'uThreshold', comparing from the most significant plane down.
+    FORCE_INLINE uint64 getBitSlicedAtOrAbove(const uint64* pPlanes, size_t uPlaneStride, uint8 uThreshold) FORCE_INLINE_END
+    {
+        uint64 uAbove = 0uLL;
+        uint64 uEqualSoFar = ~0uLL;
+        for (u8fast uPlane = 8u; uPlane-- > 0u; ) {
+            uint64 uBits = pPlanes[uPlane * uPlaneStride];
+            uint64 uThresholdBit = 0uLL - uint64((uThreshold >> uPlane) & 1u);
+            uAbove |= uEqualSoFar & uBits & ~uThresholdBit;
+            uEqualSoFar &= ~(uBits ^ uThresholdBit);
+        }
+        return uAbove | uEqualSoFar;
+    }
+
+    // Scalar version of the kernel, see above (also used for the tail of the vectorized one, from qword 'uStart')
+    inline void updateBitSlicedPermanences_scalar(uint64* pPlanes, size_t uQwordCount, const uint64* pIncreaseMasks,
+        const uint64* pDecreaseMasks, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold, uint64* pOutAtOrAbove,
+        size_t uStart)
+    {
+        const uint64 uDecreaseEnabled = 0uLL - uint64(0u != uDecrease);    // two's complement of 0 would never carry out
+        const u32fast uNegatedDecrease = u32fast(256u - uDecrease);
+        for (size_t uQword = uStart; uQword < uQwordCount; uQword++) {
+            uint64 uIncreaseMask = pIncreaseMasks[uQword];
+            uint64 uDecreaseMask = pDecreaseMasks[uQword] & uDecreaseEnabled;
+            uint64 tPlanes[8u];
+            uint64 uCarry = 0uLL;
+            for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+                uint64 uAddend = (uIncreaseMask & (0uLL - uint64((uIncrease >> uPlane) & 1u))) |
+                                 (uDecreaseMask & (0uLL - uint64((uNegatedDecrease >> uPlane) & 1u)));
+                uint64 uPrevious = pPlanes[uPlane * uQwordCount + uQword];
+                tPlanes[uPlane] = uPrevious ^ uAddend ^ uCarry;
+                uCarry = (uPrevious & uAddend) | (uCarry & (uPrevious ^ uAddend));
+            }
+            uint64 uOverflow = uCarry & uIncreaseMask;
+            uint64 uUnderflow = ~uCarry & uDecreaseMask;
+            for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+                tPlanes[uPlane] = (tPlanes[uPlane] | uOverflow) & ~uUnderflow;
+                pPlanes[uPlane * uQwordCount + uQword] = tPlanes[uPlane];
+            }
+            pOutAtOrAbove[uQword] = getBitSlicedAtOrAbove(tPlanes, 1u, uThreshold);
+        }
+    }
+    inline void updateBitSlicedPermanences_scalar(uint64* pPlanes, size_t uQwordCount, const uint64* pIncreaseMasks,
+        const uint64* pDecreaseMasks, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold, uint64* pOutAtOrAbove)
+    {
+        updateBitSlicedPermanences_scalar(pPlanes, uQwordCount, pIncreaseMasks, pDecreaseMasks, uIncrease, uDecrease,
+            uThreshold, pOutAtOrAbove, 0u);
+    }
+
+#if defined(HTMATCH_SIMD_x64)
+
+    // AVX2 version of the kernel, see above: same as the scalar one, 4 qwords (256 permanences) at a time
+    HTMATCH_TARGET_AVX2 inline void updateBitSlicedPermanences_avx2(uint64* pPlanes, size_t uQwordCount,
+        const uint64* pIncreaseMasks, const uint64* pDecreaseMasks, uint8 uIncrease, uint8 uDecrease, uint8 uThreshold,
+        uint64* pOutAtOrAbove)
+    {
+        const __m256i vDecreaseEnabled = _mm256_set1_epi64x(-int64(0u != uDecrease));
+        const u32fast uNegatedDecrease = u32fast(256u - uDecrease);
+        __m256i tIncreaseBits[8u], tDecreaseBits[8u], tThresholdBits[8u];
+        for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+            tIncreaseBits[uPlane] = _mm256_set1_epi64x(-int64((uIncrease >> uPlane) & 1u));
+            tDecreaseBits[uPlane] = _mm256_set1_epi64x(-int64((uNegatedDecrease >> uPlane) & 1u));
+            tThresholdBits[uPlane] = _mm256_set1_epi64x(-int64((uThreshold >> uPlane) & 1u));
+        }
+        size_t uVectorized = uQwordCount & ~size_t(3u);
+        for (size_t uQword = 0u; uQword < uVectorized; uQword += 4u) {
+            __m256i vIncreaseMask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIncreaseMasks + uQword));
+            __m256i vDecreaseMask = _mm256_and_si256(vDecreaseEnabled,
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDecreaseMasks + uQword)));
+            __m256i tPlanes[8u];
+            __m256i vCarry = _mm256_setzero_si256();
+            for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+                __m256i vAddend = _mm256_or_si256(_mm256_and_si256(vIncreaseMask, tIncreaseBits[uPlane]),
+                    _mm256_and_si256(vDecreaseMask, tDecreaseBits[uPlane]));
+                __m256i vPrevious = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPlanes + uPlane * uQwordCount + uQword));
+                __m256i vHalfSum = _mm256_xor_si256(vPrevious, vAddend);
+                tPlanes[uPlane] = _mm256_xor_si256(vHalfSum, vCarry);
+                vCarry = _mm256_or_si256(_mm256_and_si256(vPrevious, vAddend), _mm256_and_si256(vCarry, vHalfSum));
+            }
+            __m256i vOverflow = _mm256_and_si256(vCarry, vIncreaseMask);
+            __m256i vUnderflow = _mm256_andnot_si256(vCarry, vDecreaseMask);
+            __m256i vAbove = _mm256_setzero_si256();
+            __m256i vEqualSoFar = _mm256_set1_epi64x(-1);
+            for (u8fast uPlane = 8u; uPlane-- > 0u; ) {
+                __m256i vBits = _mm256_andnot_si256(vUnderflow, _mm256_or_si256(tPlanes[uPlane], vOverflow));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pPlanes + uPlane * uQwordCount + uQword), vBits);
+                vAbove = _mm256_or_si256(vAbove, _mm256_andnot_si256(tThresholdBits[uPlane], _mm256_and_si256(vEqualSoFar, vBits)));
+                vEqualSoFar = _mm256_andnot_si256(_mm256_xor_si256(vBits, tThresholdBits[uPlane]), vEqualSoFar);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOutAtOrAbove + uQword), _mm256_or_si256(vAbove, vEqualSoFar));
+        }
+        updateBitSlicedPermanences_scalar(pPlanes, uQwordCount, pIncreaseMasks, pDecreaseMasks, uIncrease, uDecrease,
+            uThreshold, pOutAtOrAbove, uVectorized);
+    }
+
+#endif // HTMATCH_SIMD_x64
+
+    // Returns the implementation of 'updateBitSlicedPermanences' best suited to given SIMD level
+    inline UpdateBitSlicedPermanencesFunc getUpdateBitSlicedPermanencesFunc(eSimdLevel eLevel) {
+#if defined(HTMATCH_SIMD_x64)
+        if (eLevel >= k_eSimdLevel_AVX2)
+            return updateBitSlicedPermanences_avx2;
+#else
+        HTMATCH_unused(eLevel);
+#endif
+        return updateBitSlicedPermanences_scalar;
+    }
+
+    // Returns the implementation of 'updateBitSlicedPermanences' best suited to the running CPU
+    inline UpdateBitSlicedPermanencesFunc getUpdateBitSlicedPermanencesFunc() {
+        return getUpdateBitSlicedPermanencesFunc(getSimdLevel());
+    }
+
+} // namespace HTMATCH
+
+#endif // _HTMATCH_SIMD_H
+
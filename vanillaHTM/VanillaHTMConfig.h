@@ -89,10 +89,13 @@
 #define VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONLY              10   // local inhibition with n-pass reduction by gaussian filter
                                                                    //   over a 31x31 kernel
 #define VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONE_7x7           11   // local inhibition using gaussian filter (like GAUSS_ONLY) +
-                                                                   //   single-winner over 7x7 kernel (=> fixed ~2% sparsity)
+                                                                   //   single-winner over 7x7 kernel (=> at most 128 winners,
+                                                                   //   one per 4x4 tile ; typically ~1.2% sparsity)
 #define VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ENFORCEDSPACING   12   // local inhibition using gaussian filter (like GAUSS_ONLY) +
                                                                    //   enforced min euclidean distance 6.5
                                                                    //   => max ~2.75%, hopefully mean 2%
+#define VANILLA_SP_CONFIG_CONST_LOCAL_BOXGAUSS_ONLY           13   // local inhibition like GAUSS_ONLY, but with the gaussian
+                                                                   //   approximated by a cascade of three box filters
 //----------------------------------------
 // Vanilla SpatialPooler synaptic configurations
 //   #define VANILLA_SP_SYNAPSE_KIND to one of the following values before including "VanillaSPGen.h"
@@ -104,6 +107,9 @@
                                                            //   where max value of 65535 represents 1.0
 #define VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8      3    // synapse permanence is [0 .. 255] stored in uint8,
                                                            //   where max value of 255 represents 1.0
+#define VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8  4    // same [0 .. 255] permanence as above, yet stored as 8 bitplanes
+                                                           //   laid out like the connectivity fields (one bit per presynaptic
+                                                           //   cell per plane) => requires VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
 
 //----------------------------------------
 // Vanilla SpatialPooler, other configuration constants
@@ -139,6 +145,8 @@
 #define VANILLA_SP_BUCKET_SIDE       16u  // Side size of buckets in bucket neighborhood mode (=> 16x16 squares)
 #define VANILLA_SP_LOCAL_RADIUS      9u   // Fixed size of neighboring radius in local neighborhood mode (=> 19x19 kernels)
 #define VANILLA_SP_GAUSS_RADIUS      15u  // Fixed size of radius in gaussian local neighborhood mode (=> 31x31 kernels)
+#define VANILLA_SP_BOXGAUSS_RADIUS   5u   // Radius of each of the three cascaded boxes in box-gaussian mode (=> 11 wide each,
+                                          //   for a combined variance of 30, close to the 28.9 of the gaussian kernel)
 
 #define VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL             1    // local inhibition is centered on currently considered column
 #define VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET              2    // local inhibition is in fact setup as fixed, separated "buckets"
@@ -151,6 +159,8 @@
 #define VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM   1    // multi-pass optimizations and tweaks applied to neighbor searches.
 #define VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER 2    // diff against med-sized gaussian filter, then one-winner on 7x7
                                                              //   kernel (=>fixed ~2% density)
+#define VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER 3 // same as above, with the gaussian filter approximated by
+                                                             //   running sums (constant cost per column, whatever radius)
 
 #define VANILLA_SP_MIN_AREA_SIDE_SIZE                   6u   // less than radius 3 (inhib or potential) and we'd be better
                                                              //   resorting to global
@@ -162,5 +172,67 @@
 //   then we can perform a brute-force bitwise 'AND' against an input bitfield to compute active count for a segment.
 #define VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI                1
 
+// Layout option for the connectivity fields above
+//   if defined, and whenever potential pools are local (neither global, nor spanning the whole sheet width), a connectivity
+//   field only stores the qwords covering the potential window of its column along x (with wrap-around), for each input
+//   sheet, instead of the whole input. With default potential radius of 12, this means 13 qwords per sheet instead of 32.
+#define VANILLA_SP_USE_WINDOWED_CONNECTIVITY_FIELDS           1
+
+// Estimated relative cost of gathering one qword of connectivity field at some arbitrary offset, vs. loading it as part
+//   of a full, contiguous connectivity field. Used for choosing per call whether we AND against the whole input, or rather
+//   against the compacted list of its non-zero qwords only.
+#define VANILLA_SP_GATHERED_INPUT_COST_RATIO                  3u
+
+// Additional optimization on top of the connectivity fields above
+//   if defined, we also maintain an inverted index from each presynaptic cell to the list of columns it is currently
+//   connected to. Whenever input is sparse enough, computing active counts then boils down to walking the lists of the
+//   active input cells only, instead of AND-ing every connectivity field against the whole input. Choice between the two
+//   is performed on each call, based on the popcount of the input.
+#define VANILLA_SP_USE_SPARSE_INPUT_OPTI                      1
+
+// Estimated relative cost of one (scattered) increment of an active count when walking the inverted index above, vs. the
+//   cost of AND-ing and counting one qword of connectivity field in the dense way (with the vectorized kernels).
+//   Used for the per-call choice. With default params, sparse path gets selected below ~5% input density.
+#define VANILLA_SP_SPARSE_INPUT_COST_RATIO                    4u
+
+// Batched inference (@see VanillaSP::computeBatch()): number of inputs processed together as a tile, and approximate byte size
+//   of each block of connectivity fields which is applied to a whole tile of inputs before moving on to the next block.
+//   The block is sized to stay cache-resident while the tile is processed, so that each field is streamed once per tile.
+#define VANILLA_SP_BATCH_INPUT_TILE_SIZE                      16u
+#define VANILLA_SP_BATCH_FIELDS_BLOCK_BYTES                   65536u
+
+// Define the following (here, or before including any VanillaSP header) to select the active columns under nominal local
+//   inhibition with a sliding-window histogram of activation levels (in the way of Huang's median filter), instead of one
+//   k-best search per neighborhood: each step of the window only adds and removes one strip of levels, so that cost no longer
+//   grows quadratically with inhibition radius. Does not apply when the gaussian filter is used. Selection is the same for
+//   raw levels ; boosted levels are binned with a relative precision of at least 1/128, and columns falling in the same bin
+//   as the K+1-th best level of their neighborhood lose.
+//#define VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB                1
+
+// Define the following (here, or before including any VanillaSP header) to integrate the moving averages of column usage
+//   lazily: each learning step then only touches the columns which were over threshold (resp. active), all others catching
+//   up with the decay they missed in closed form, once their averages get read in bulk (by boosting, target and under-used
+//   column updates, every 32 or 64 steps). Same averages up to float rounding ; per-step cost now follows the number of
+//   such columns instead of the 2048 ones.
+//#define VANILLA_SP_USE_LAZY_COLUMN_USAGE                    1
+
+// Define the following (here, or before including any VanillaSP header) to compile-in support for an optional intra-step
+//   parallel mode, which can then be switched on at runtime on a given SP (@see VanillaSP::setParallelCompute()).
+//   Overlap computation and boost application are then split across worker threads by ranges of columns, winner selection
+//   and statistics under bucket inhib by bucket, and synapse updates by active column, with results bit-identical to the
+//   sequential path. Requires a standard library providing parallel
+//   algorithms (with GCC's libstdc++, this means linking against TBB).
+//#define VANILLA_SP_ALLOW_PARALLEL_COMPUTE                   1
+
+// Number of columns in each of the ranges handed to worker threads in parallel mode above (shall divide 2048)
+#define VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE                 128u
+
+#if defined(VANILLA_SP_USE_SPARSE_INPUT_OPTI) && !defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI)
+#  error "VANILLA_SP_USE_SPARSE_INPUT_OPTI requires VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI"
+#endif
+#if defined(VANILLA_SP_USE_WINDOWED_CONNECTIVITY_FIELDS) && !defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI)
+#  error "VANILLA_SP_USE_WINDOWED_CONNECTIVITY_FIELDS requires VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI"
+#endif
+
 #endif // _VANILLA_HTM_CONFIG_H
 
@@ -3,7 +3,7 @@
  * VanillaSPGen.h
  * -----------------------------------
  * Expands VANILLA_SP* configuration choices to second-order options, then declares the VanillaSP class
- *   which implements a vanilla-HTM-like Spatial Pooler
+ *   which implements a vanilla-HTM-like Spatial Pooler (and FrozenVanillaSP, its immutable inference-only counterpart)
  * Warning : No multi-inclusion guard !!!
  *   This file is intended to be included multiple times with different config options indeed, if the user wishes so.
  *      (to have multiple declared versions, you may #define VANILLA_SP_SUBNAMESPACE to an identifier of your choice) 
@@ -45,7 +45,7 @@
 #  undef VANILLA_SP_FORCE_NONLOCAL_STATS
 #endif
 #ifdef VANILLA_SP_MAX_GAUSSIAN_ITER
-#  undef VANILLA_SP_GAUSSIAN_ITER
+#  undef VANILLA_SP_MAX_GAUSSIAN_ITER
 #endif
 #ifdef VANILLA_SP_GAUSSIAN_SCALE_TARGET
 #  undef VANILLA_SP_GAUSSIAN_SCALE_TARGET
@@ -132,12 +132,22 @@
 #    else
 //   always use gauss filter method as a first sparsifier in the following
 #            define VANILLA_SP_UPDATERAD_KIND        VANILLA_SP_UPDATERAD_KIND_CONST_NOUPDATE
-#            define VANILLA_SP_NEIGHBORHOOD_OPTIM    VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER
 #            define VANILLA_SP_FORCE_NONLOCAL_STATS  1
+#      if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_BOXGAUSS_ONLY)
+#            define VANILLA_SP_NEIGHBORHOOD_OPTIM    VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER
+#      else
+#            define VANILLA_SP_NEIGHBORHOOD_OPTIM    VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER
+#      endif
 #      if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONLY)
 #            define VANILLA_SP_MAX_GAUSSIAN_ITER     2
 #            define VANILLA_SP_GAUSSIAN_SCALE_TARGET 42
+#      elif (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_BOXGAUSS_ONLY)
+#            define VANILLA_SP_MAX_GAUSSIAN_ITER     2
+#            define VANILLA_SP_GAUSSIAN_SCALE_TARGET 42
 #      elif (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONE_7x7)
+//             no two winners within a 7x7 => at most one per 4x4 tile, ie. 128 winners, whatever the params below.
+//             Those leave less than 64 candidates to the 7x7 step, typically ~25 winners (1.2%) ; raising the scale
+//             target only brings it to ~34 (1.7%), winners then being limited by the 7x7 step itself.
 #            define VANILLA_SP_MAX_GAUSSIAN_ITER     3
 #            define VANILLA_SP_GAUSSIAN_SCALE_TARGET 64
 #            define VANILLA_SP_ADD_ONE_7x7           1
@@ -174,7 +184,8 @@
 #  define VANILLA_SP_SYN_CONNECTED_PERM             8738u           // quite precisely the 0.13333 above
 #  define VANILLA_SP_SYN_PERM_BELOW_STIM_INC        1092u           // quite precisely the 0.016667 above
 #  define VANILLA_SP_SYN_PERM_TYPE_MAX              65535           // shall never be crossed, and represents 1.0
-#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8)
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8) || \
+      (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
 #  define VANILLA_SP_SYN_PERM_TYPE                  uint8           // 8b fixed point [0..255] representing [0.0 .. 1.0]
 #  define VANILLA_SP_SYN_SIGNED_PERM_TYPE           int32           // we'll compute a few things on signed int32 before
                                                                     //   casting back to uint8
@@ -186,8 +197,15 @@
 #else
 #  error "no permanence values were adjusted for this value of VANILLA_SP_SYNAPSE_KIND"
 #endif
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8) && !defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI)
+#  error "VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8 requires VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI"
+#endif
 
 #include "tools/sdr.h"
+#include "tools/simd.h"
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+#  include "tools/parallel.h"
+#endif
 
 namespace HTMATCH {
 #if defined(VANILLA_SP_SUBNAMESPACE)
@@ -201,6 +219,165 @@ namespace HTMATCH {
 // - - - - - - - - - - - - - - - - - - - -
 
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+class FrozenVanillaSP;
+#endif
+
+// - - - - - - - - - - - - - - - - - - - -
+// VanillaSPScratch struct
+// - - - - - - - - - - - - - - - - - - - -
+// Temporary buffers required while selecting the active columns for a given input. Each VanillaSP holds its own, and each
+//   thread serving a same FrozenVanillaSP shall hold its own as well (@see FrozenVanillaSP::Context)
+// - - - - - - - - - - - - - - - - - - - -
+struct VanillaSPScratch {
+    VanillaSPScratch(size_t uInputQwordCount);
+    ~VanillaSPScratch();
+
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    uint32* _pTmpActiveInputQwordOffsets;           // compacted list of the non-zero qwords of current input (offsets)
+    uint64* _pTmpActiveInputQwordValues;            // compacted list of the non-zero qwords of current input (values)
+#endif
+    uint32* _pTmpTableBest;                         // sized for up to VANILLA_SP_MAX_WINNERS (+1) best values
+    uint16* _pTmpRadixSelectCounts;                 // per-digit counts for the whole-sheet radix select of global inhib
+    uint32* _pTmpRadixSelectCandidates;             // ... and levels sharing the selected digit
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+#    ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+    uint16* _pTmpHistogramFineCounts;               // sliding-window histogram of activation levels, one count per bin...
+    uint16* _pTmpHistogramCoarseCounts;             // ... and one per group of bins
+    uint32* _pTmpBelowMinPerCol;                    // level to beat, per column, as found by the sliding window
+#    endif
+#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+        (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    uint32* _pTmpGaussY;
+    uint32* _pTmpGaussX;
+    uint32* _pReducedActivations;
+#    elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
+    uint32* _pTmpKBestLists;                        // G and RevH k-best lists along Y, then along X...
+    size_t _uKBestListsTableSize;                   // ... of up to that many (K+1) values each, grown on demand
+    void _reserveKBestLists(size_t uTableSize);
+#    endif
+#  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
+    uint16* _pTmpBucketWinners;                     // winners of each bucket, in a slot of bucket size per bucket...
+    uint16* _pTmpBucketWinnerCounts;                // ... and their count, per bucket
+#  endif
+#endif
+};
+
+// - - - - - - - - - - - - - - - - - - - -
+// VanillaSPInferenceCore class
+// - - - - - - - - - - - - - - - - - - - -
+// The part of the Spatial Pooler state which is required to select the active columns for a given input (connectivity,
+//   boost factors, inhibition parameters), together with the const methods doing so. VanillaSP derives from it and keeps
+//   that state up to date while learning ; FrozenVanillaSP derives from it too, holding an immutable copy of that state.
+// - - - - - - - - - - - - - - - - - - - -
+class VanillaSPInferenceCore {
+protected:
+
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+    // Implements the AND-then-popcount way of computing raw activation levels over a range of columns only,
+    //   either against the whole input, or against its compacted list of non-zero qwords. With windowed connectivity fields,
+    //   windowed input and its compaction are rather computed here for each x, and the range shall be a multiple of 32.
+    void _computeUnrestrictedActivationLevelsOnColumnRange(const uint64* pInputBinaryBitmap,
+        const uint32* pActiveQwordOffsets, const uint64* pActiveQwordValues, size_t uActiveQwordCount, bool bGatherActiveQwords,
+        size_t uColumnStart, size_t uColumnCount, uint16* pOutputActivationLevelsPerCol) const;
+
+    // Returns the first qword (among the qwords of an input sheet) covered by the connectivity fields of the columns at 'uX'.
+    //   Always 0 if connectivity fields are not windowed.
+    size_t _getConnectivityWindowStartQword(u16fast uX) const;
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+    // Will select the winning, 'active' columns on this round from either raw or boosted activation levels
+    //   ('ActivationLevelType' will discriminate between the two), relative to neighborhood, by chosing a total number of active
+    //   columns equal (or hopefully close to) fActivationDensityRatio * VANILLA_HTM_SHEET_2DSIZE
+    // 'pOutputBinaryBitmap' is required here: it gets cleared, then each winner sets its bit there as soon as it is selected
+    template<typename ActivationLevelType>
+    void _getActiveColumnsFromActivationLevels(const ActivationLevelType* pActivationLevelsPerCol,
+        std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+        VanillaSPScratch& scratch) const;
+
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+
+    // implements _getActiveColumnsFromActivationLevels() when local inhib can be computed along x coordinates only
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    void _getActiveColumnsFromActivationLevelsWithLocalInhibAlongX(const ActivationLevelType* pActivationLevelsPerCol,
+        std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+        VanillaSPScratch& scratch) const;
+
+    // implements _getActiveColumnsFromActivationLevels() when local inhib requires full-blown neighborhood per column
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    void _getActiveColumnsFromActivationLevelsWithFullLocalInhib(const ActivationLevelType* pActivationLevelsPerCol,
+        std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+        VanillaSPScratch& scratch) const;
+
+#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+        (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    void _reduceActivationsByGaussianFilter(const ActivationLevelType* pActivationLevelsPerCol, uint32* pOutputMinActivation,
+        VanillaSPScratch& scratch) const;
+
+#    endif // VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER
+
+#  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
+
+    // implements _getActiveColumnsFromActivationLevels() when bucket inhib mode is selected
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    void _getActiveColumnsFromActivationLevelsWithBucketInhib(const ActivationLevelType* pActivationLevelsPerCol,
+        std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+        VanillaSPScratch& scratch) const;
+
+    // Selects the winners of a single bucket (buckets being numbered along y first), writing their indices to 'pOutWinners'
+    //   in increasing index order, and returning their count. Only reads levels of, and writes min activations to, the
+    //   columns of that bucket (=> thread-safe across distinct buckets).
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    u16fast _getWinnersInBucket(u16fast uBucket, const ActivationLevelType* pActivationLevelsPerCol, uint16* pOutWinners,
+        uint32* pOutputMinActivations) const;
+
+#  endif // value of VANILLA_SP_USE_LOCAL_INHIB
+#endif // VANILLA_SP_USE_LOCAL_INHIB
+
+    // implements _getActiveColumnsFromActivationLevels() when global inhibition is selected
+    template<typename ActivationLevelType, bool bOutputMinActivation>
+    void _getActiveColumnsFromActivationLevelsWithGlobalInhib(const ActivationLevelType* pActivationLevelsPerCol,
+        std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+        VanillaSPScratch& scratch) const;
+
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    uint64* _pConnectivityFields;                   // ... here one such bitfield for each minicolumn !
+    size_t  _uConnectivityFieldsQwordSizePerColumn;
+    size_t  _uConnectivityFieldsQwordSizePerSheet;  // qwords per input sheet in each field: 32, or less when windowed
+    size_t  _uInputQwordCount;                      // qwords in an input bitfield (32 per input sheet)
+    AndCountSetBitsPerRowFunc _pAndCountSetBitsPerRowFunc;  // overlap kernel, chosen at construction from CPU features
+    AndCountSetBitsPerRowGatheredFunc _pAndCountSetBitsPerRowGatheredFunc;  // ... and its variant for sparse inputs
+#endif
+    CompressIndicesAbove16Func _pCompressIndicesAbove16Func;    // winner emission kernels for global inhib, chosen at
+    CompressIndicesAbove32Func _pCompressIndicesAbove32Func;    //   construction from CPU features (raw, and boosted)
+    ConvolveLinesWrappedFunc _pConvolveAlongLinesWrappedFunc;  // gaussian filter kernels (along columns, then across
+    ConvolveLinesWrappedFunc _pConvolveAcrossLinesWrappedFunc; //   them), chosen at construction from CPU features
+    MaskAbove16Func _pMaskAbove16Func;              // per-bucket selection kernels for bucket inhib, chosen at
+    MaskAbove32Func _pMaskAbove32Func;              //   construction from CPU features (raw, and boosted)
+#ifdef VANILLA_SP_USE_BOOSTING
+    uint16* _pBoostingPerCol;
+#endif
+
+    uint8 _uPotentialConnectivityRadius;
+    uint8 _uInhibitionRadius;
+    uint8 _uInhibitionSideSize;
+    uint8 _uInputSheetsCount;
+    // additional properties for when bucket inhib mode is selected
+    uint8 _uBucketSize;
+    uint8 _uBucketCountY;
+
+    size_t _uCurrentWinnerK;
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    bool _bParallelCompute;                         // whether intra-step parallel mode is currently on (never on a frozen SP)
+#endif
+};
+
 // - - - - - - - - - - - - - - - - - - - -
 // VanillaSP class
 // - - - - - - - - - - - - - - - - - - - -
@@ -216,7 +393,7 @@ namespace HTMATCH {
 // Also, the Spatial Pooler models the biological "proximal synapses" of several cells
 //   in a single cortical minicolumn, as theorized by HTM.
 // - - - - - - - - - - - - - - - - - - - -
-class VanillaSP {
+class VanillaSP : private VanillaSPInferenceCore {
 public:
 
     // Only available Ctor
@@ -290,6 +467,33 @@ public:
         _compute(pInputBinaryBitmap, vecOutputIndices, bLearning, pOutputBinaryBitmap, pOutputMinActivations);
     }
 
+    // - - - - - - - - - - - - - - - - - - - -
+    // Allocation-free signature for the "compute" method, for hot loops: input in bitfield-form (not copied), and active
+    //   indices written to a caller-owned array of 'uOutputCapacity' elements (VANILLA_SP_MAX_WINNERS is enough under global
+    //   inhibition). Returns the number of active columns ; should it exceed 'uOutputCapacity', only the first ones are
+    //   written there (learning still considers all of them). No heap activity once constructed.
+    // Optional: if non-null, pOutputBinaryBitmap will be filled with the same info directly by the winner selection.
+    // - - - - - - - - - - - - - - - - - - - -
+    size_t compute(const uint64* pInputBinaryBitmap, uint16* pOutputIndices, size_t uOutputCapacity, bool bLearning = true,
+        uint64* pOutputBinaryBitmap = 0, uint32* pOutputMinActivations = 0) {
+        _compute(pInputBinaryBitmap, _vecTmpOutputIndices, bLearning, pOutputBinaryBitmap, pOutputMinActivations);
+        size_t uActiveCount = _vecTmpOutputIndices.size();
+        memcpy((void*)pOutputIndices, _vecTmpOutputIndices.data(), std::min(uActiveCount, uOutputCapacity) * sizeof(uint16));
+        return uActiveCount;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Batched inference version of the "compute" method (no learning), for many inputs presented in bitfield-form, one after
+    //   the other in 'pInputBinaryBitmaps'. Results are the same as 'uInputCount' calls to compute() with bLearning = false,
+    //   however each connectivity field gets streamed from memory only once per tile of inputs instead of once per input.
+    // Outputs: if non-null, 'pOutputIndicesPerInput' shall point to an array of 'uInputCount' vectors, receiving active indices
+    //   for each input ; if non-null, 'pOutputBinaryBitmaps' shall hold 'uInputCount' consecutive output bitfields.
+    // - - - - - - - - - - - - - - - - - - - -
+    void computeBatch(const uint64* pInputBinaryBitmaps, size_t uInputCount, std::vector<uint16>* pOutputIndicesPerInput,
+        uint64* pOutputBinaryBitmaps = 0) {
+        _computeBatch(pInputBinaryBitmaps, uInputCount, pOutputIndicesPerInput, pOutputBinaryBitmaps);
+    }
+
     // - - - - - - - - - - - - - - - - - - - -
     // Returns the raw activation levels (number of active presynaptic cells) which were used at previous call of 'compute'.
     //   results are presented col-major across the 2048 minicolumns
@@ -333,6 +537,37 @@ public:
     // - - - - - - - - - - - - - - - - - - - -
     uint8 getInhibitionSideSize() const { return _uInhibitionSideSize; }
 
+    // - - - - - - - - - - - - - - - - - - - -
+    // Switches the maintenance of under-used columns to burst mode (off by default). By default, permanences of under-used
+    //   columns get bumped on a rotating slice of the columns at each learning step, so that all columns are visited once
+    //   per period. In burst mode, all columns are visited at once on a single step of each period, as originally, at the
+    //   cost of a latency spike on that step.
+    // - - - - - - - - - - - - - - - - - - - -
+    void setUnderUsedColumnsBurstMode(bool bBurstMode) { _bUnderUsedColumnsBurstMode = bBurstMode; }
+    bool isUnderUsedColumnsBurstMode() const { return _bUnderUsedColumnsBurstMode; }
+
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // - - - - - - - - - - - - - - - - - - - -
+    // Switches the streaming mode on or off (off by default), for temporally correlated inputs. When on, previous input and raw
+    //   activation levels are kept from one call to 'compute' to the next, and new levels are obtained by only adjusting those
+    //   of the columns connected to the input bits which flipped since then. Levels are fully recomputed whenever learning
+    //   changed connectivity in-between, or if too many bits flipped.
+    // - - - - - - - - - - - - - - - - - - - -
+    void setStreamingMode(bool bStreamingMode) { _bStreamingMode = bStreamingMode; _bStreamingStateValid = false; }
+    bool isStreamingMode() const { return _bStreamingMode; }
+#endif
+
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    // - - - - - - - - - - - - - - - - - - - -
+    // Switches the intra-step parallel mode on or off (off by default). When on, overlap computation, boost application,
+    //   winner selection under bucket inhib, and synapse updates of the active columns get split across worker threads on
+    //   each call to 'compute'.
+    //   Active columns and learned state are bit-identical to the ones obtained in sequential mode.
+    // - - - - - - - - - - - - - - - - - - - -
+    void setParallelCompute(bool bParallelCompute) { _bParallelCompute = bParallelCompute; }
+    bool isParallelCompute() const { return _bParallelCompute; }
+#endif
+
     // - - - - - - - - - - - - - - - - - - - -
     // Defines the 'segment' structure held by each minicolumn,
     //   biologically representing 'proximal' parts of dendrites in case of the SP.
@@ -346,11 +581,15 @@ public:
         // Table of pre-synaptic cell indices, for each of the potential synapse (col-major, depth-last)
         uint16 _tPreSynIndex[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
 
+#if (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
         // Table of current permanence values. This is the heart of the dynamic part of the model, and where most of the
         //   learning ability reside. Once a permanence value reaches or exceeds 'VANILLA_SP_SYN_CONNECTED_PERM', the synapse is
         //   considered 'connected', and will then be allowed to take into account the activity of the associated presynaptic
         //   cell on each round, when it is time to compute the current activation level of the segment.
         VANILLA_SP_SYN_PERM_TYPE _tPermValue[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+#else
+        // (with bit-sliced permanences, those are rather found in the bitplanes of the column, @see _pPermanencePlanes)
+#endif
     };
 
     // - - - - - - - - - - - - - - - - - - - -
@@ -430,15 +669,116 @@ private:
     // *** *** *** *** *** *** *** *** *** ***
     // *** *** *** *** *** *** *** *** *** ***
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    friend class FrozenVanillaSP;   // reads the inference state at freeze time
+#endif
+
     // Implements the two variants of the public 'compute' interface above, in same way.
     //   Yes, it means the implementation prefer brute-force bitfield inputs.
     void _compute(const uint64* pInputBinaryBitmap, std::vector<uint16>& vecOutputIndices, bool bLearning,
         uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations);
 
+    // Implements the public 'computeBatch' interface above.
+    void _computeBatch(const uint64* pInputBinaryBitmaps, size_t uInputCount, std::vector<uint16>* pOutputIndicesPerInput,
+        uint64* pOutputBinaryBitmaps);
+
     // Will compute the initial (unihibited) activation levels for each colums, based on current input and current state of
     //   synaptic connections to them (Working against bitfield input)
     void _computeUnrestrictedActivationLevels(const uint64* pInputBinaryBitmap, uint16* pOutputActivationLevelsPerCol) const;
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+    // Computes the initial activation levels for a whole tile of inputs at once, for _computeBatch(), applying each block
+    //   of connectivity fields to all inputs of the tile in turn. Results are output per input, 2048 levels each.
+    void _computeUnrestrictedActivationLevelsForTile(const uint64* pInputBinaryBitmaps, size_t uInputCount,
+        uint16* pOutputActivationLevelsPerInput) const;
+
+    // Implements _computeUnrestrictedActivationLevelsForTile() over a block of columns
+    void _computeUnrestrictedActivationLevelsForTileOnColumnRange(const uint64* pInputBinaryBitmaps, size_t uInputCount,
+        size_t uColumnStart, size_t uColumnCount, uint16* pOutputActivationLevelsPerInput) const;
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+    // Alternate implementation of _computeUnrestrictedActivationLevels(), walking the inverted index lists of active input
+    //   cells only. Preferred by the former whenever input is sparse enough.
+    //   Works from the compacted list of non-zero input qwords.
+    void _computeUnrestrictedActivationLevelsFromInvertedIndex(const uint32* pActiveQwordOffsets,
+        const uint64* pActiveQwordValues, size_t uActiveQwordCount, uint16* pOutputActivationLevelsPerCol) const;
+
+    // Alternate implementation of _computeUnrestrictedActivationLevels() in streaming mode: adjusts the activation levels
+    //   'pInOutActivationLevelsPerCol', which were computed against 'pPreviousInputBinaryBitmap', towards the new input, by
+    //   walking the inverted index lists of the flipped input cells only.
+    void _updateUnrestrictedActivationLevelsFromInputChanges(const uint64* pInputBinaryBitmap,
+        const uint64* pPreviousInputBinaryBitmap, uint16* pInOutActivationLevelsPerCol) const;
+
+    // (Re)builds the whole presynaptic-to-columns inverted index from current segments and connectivity fields.
+    //   Called at construction time. Afterwards, the index is maintained incrementally, as connectivity fields are.
+    void _rebuildInvertedIndex();
+
+    // Adds column 'uColumnIndex' to the inverted index list of presynaptic cell 'uPreSynCellIndex'
+    void _addToInvertedIndex(u16fast uColumnIndex, u16fast uPreSynCellIndex);
+
+    // Removes column 'uColumnIndex' from the inverted index list of presynaptic cell 'uPreSynCellIndex'
+    void _removeFromInvertedIndex(u16fast uColumnIndex, u16fast uPreSynCellIndex);
+
+#endif // VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+    // Computes the connectivity field of column 'uColumnIndex' from scratch, based on current state of its segment
+    void _initConnectivityField(u16fast uColumnIndex);
+
+    // Returns the position of the qword holding the bit of presynaptic cell 'uPreSynCellIndex' in the connectivity field of
+    //   column 'uColumnIndex'. Cells outside of the window of that column yield a position past the end of the field.
+    size_t _getConnectivityFieldQwordPos(u16fast uColumnIndex, u32fast uPreSynCellIndex) const;
+
+    // Reverse of the above: returns the presynaptic cell index associated to bit 'uBit' of the qword at position
+    //   'uFieldQwordPos' in the connectivity field of column 'uColumnIndex'
+    u32fast _getPreSynCellIndexFromFieldPos(u16fast uColumnIndex, size_t uFieldQwordPos, u16fast uBit) const;
+
+    // Sets the bit associated with 'uPreSynCellIndex' in the connectivity field of column 'uColumnIndex', when one of its
+    //   synapses becomes connected (also maintaining the inverted index, if selected).
+    //   If 'ppDeferredIndexUpdates' is non-null, changes to the inverted index are not applied but rather recorded there
+    //   (advancing the pointed-to cursor), to be applied later on by _applyDeferredIndexUpdates()
+    void _connectSynapseInField(uint64* pConnectivityField, u16fast uColumnIndex, u16fast uPreSynCellIndex,
+        uint32** ppDeferredIndexUpdates);
+
+    // Clears the bit associated with 'uPreSynCellIndex' in the connectivity field of column 'uColumnIndex', when one of its
+    //   synapses becomes unconnected (also maintaining the inverted index, if selected, or deferring it as above)
+    void _disconnectSynapseInField(uint64* pConnectivityField, u16fast uColumnIndex, u16fast uPreSynCellIndex,
+        uint32** ppDeferredIndexUpdates);
+
+#  if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+
+    // Computes the potential field and permanence bitplanes of column 'uColumnIndex' from scratch, based on the current
+    //   potential pool of its segment, and on 'pPermValues', one permanence value per synapse of that segment.
+    //   (Connectivity field shall then be recomputed, by _initConnectivityField())
+    void _initPermanencePlanes(u16fast uColumnIndex, const VANILLA_SP_SYN_PERM_TYPE* pPermValues);
+
+    // Returns the permanence of the synapse from presynaptic cell 'uPreSynCellIndex' on column 'uColumnIndex', as found in
+    //   its bitplanes (0 for cells outside of its window)
+    VANILLA_SP_SYN_PERM_TYPE _getPermanenceFromPlanes(u16fast uColumnIndex, u32fast uPreSynCellIndex) const;
+
+    // Sets the permanence of the synapse from presynaptic cell 'uPreSynCellIndex' on column 'uColumnIndex' in its bitplanes,
+    //   also adding that cell to its potential field. Ignored for cells outside of its window. Connectivity field is left as is.
+    void _setPermanenceInPlanes(u16fast uColumnIndex, u32fast uPreSynCellIndex, VANILLA_SP_SYN_PERM_TYPE permanence);
+
+    // Retrieves from the bitplanes the permanence values of all synapses of column 'uColumnIndex', in the order of its segment
+    void _gatherPermanencesFromPlanes(u16fast uColumnIndex, VANILLA_SP_SYN_PERM_TYPE* pOutPermValues) const;
+
+    // Adds 'uIncrease' to all potential synapses of column 'uColumnIndex' whose presynaptic bit is set in 'pInputBinaryBitmap',
+    //   and removes 'uDecrease' from all others (with saturation) through the bit-sliced kernel, then updates its
+    //   connectivity field for those crossing the connection threshold (@see _connectSynapseInField() for 'ppDeferredIndexUpdates').
+    //   A null 'pInputBinaryBitmap' stands for an all-ones input.
+    void _updatePermanencePlanes(const uint64* pInputBinaryBitmap, u16fast uColumnIndex, uint8 uIncrease, uint8 uDecrease,
+        uint32** ppDeferredIndexUpdates);
+
+#  endif
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
 #ifdef VANILLA_SP_USE_BOOSTING
 
     // Implements the bulk of the _compute() method once raw activation levels have been computed, when use_boosting config option is on
@@ -466,13 +806,6 @@ private:
 
 #endif // VANILLA_SP_USE_BOOSTING
 
-    // Will select the winning, 'active' columns on this round from either raw or boosted activation levels
-    //   ('ActivationLevelType' will discriminate between the two), relative to neighborhood, by chosing a total number of active
-    //   columns equal (or hopefully close to) fActivationDensityRatio * VANILLA_HTM_SHEET_2DSIZE
-    template<typename ActivationLevelType>
-    void _getActiveColumnsFromActivationLevels(const ActivationLevelType* pActivationLevelsPerCol,
-        std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations);
-
 #ifdef VANILLA_SP_USE_LOCAL_INHIB
 
     // May update the inhibition range dynamically, depending on the inhibition radius options
@@ -481,27 +814,6 @@ private:
 
 #  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
 
-    // implements _getActiveColumnsFromActivationLevels() when local inhib can be computed along x coordinates only
-    template<typename ActivationLevelType, bool bOutputMinActivation>
-    void _getActiveColumnsFromActivationLevelsWithLocalInhibAlongX(const ActivationLevelType* pActivationLevelsPerCol,
-        std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations);
-
-    // implements _getActiveColumnsFromActivationLevels() when local inhib requires full-blown neighborhood per column
-    template<typename ActivationLevelType, bool bOutputMinActivation>
-    void _getActiveColumnsFromActivationLevelsWithFullLocalInhib(const ActivationLevelType* pActivationLevelsPerCol,
-        std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations);
-
-#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER)
-
-    template<typename ActivationLevelType, bool bOutputMinActivation>
-    void _reduceActivationsByGaussianFilter(const ActivationLevelType* pActivationLevelsPerCol, uint32* pOutputMinActivation);
-
-    uint32* _pTmpGaussY;
-    uint32* _pTmpGaussX;
-    uint32* _pReducedActivations;
-
-#    endif // VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSTEST or VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ENFSPACING
-
 #    ifdef VANILLA_SP_USE_BOOSTING
 
     // implements _onEvaluateBoostingFromColumnUsage() when local inhib can be computed along x coordinates only
@@ -520,11 +832,6 @@ private:
 
 #  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
 
-    // implements _getActiveColumnsFromActivationLevels() when bucket inhib mode is selected
-    template<typename ActivationLevelType, bool bOutputMinActivation>
-    void _getActiveColumnsFromActivationLevelsWithBucketInhib(const ActivationLevelType* pActivationLevelsPerCol,
-        std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations);
-
 #    ifdef VANILLA_SP_USE_BOOSTING
 
     // implements _onEvaluateBoostingFromColumnUsage() when bucket inhib mode is selected
@@ -539,11 +846,6 @@ private:
 
 #endif // VANILLA_SP_USE_LOCAL_INHIB
 
-    // implements _getActiveColumnsFromActivationLevels() when global inhibition is selected
-    template<typename ActivationLevelType, bool bOutputMinActivation>
-    void _getActiveColumnsFromActivationLevelsWithGlobalInhib(const ActivationLevelType* pActivationLevelsPerCol,
-        std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations);
-
     // implements _onUpdateOverThresholdRatioTarget() when global inhibition is selected
     void _onUpdateOverThresholdRatioTargetWithGlobalInhib();
 
@@ -552,11 +854,58 @@ private:
     void _updateSynapsesOnActiveColumnsTowardsCurrentInput(const uint64* pInputBinaryBitmap,
         const std::vector<uint16>& vecActiveIndices);
 
+    // Implements _updateSynapsesOnActiveColumnsTowardsCurrentInput() for a single active column. Only touches the segment
+    //   and connectivity field of that column (=> thread-safe across distinct columns), except for the inverted index, if
+    //   selected, unless its updates are deferred (@see _connectSynapseInField())
+    void _updateSynapsesOnColumnTowardsCurrentInput(const uint64* pInputBinaryBitmap, u16fast uColumnIndex,
+        uint32** ppDeferredIndexUpdates);
+
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
+    // Implements _updateSynapsesOnActiveColumnsTowardsCurrentInput() when parallel mode is on: one task per active column,
+    //   then inverted index updates, if any, applied sequentially in same order as the sequential path would
+    void _updateSynapsesOnActiveColumnsInParallel(const uint64* pInputBinaryBitmap,
+        const std::vector<uint16>& vecActiveIndices);
+
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // Ensures the deferred index update buffers can hold the updates of at least 'uColumnCount' columns
+    void _reserveDeferredIndexUpdates(size_t uColumnCount);
+
+    // Applies to the inverted index the updates recorded for column 'uColumnIndex' in slot 'uSlot' of the buffers above
+    void _applyDeferredIndexUpdates(u16fast uColumnIndex, size_t uSlot);
+#  endif
+
+#endif // VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
     // Will update column usage ratios for all columns, taking into account column activity this round
     void _onEvaluateColumnUsage(const uint16* pRawActivationLevelsPerCol, const uint64* pResultingBinaryBitmap);
 
-    // Will increase all synaptic permanence values on columns which are deemed under-used
-    void _onIncreasePermanencesForUnderUsedColums();
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    // Brings the column usage averages of columns in range up to learning epoch 'uEpoch', applying the decay they missed since
+    //   their last update. To be called before reading those averages in bulk.
+    void _materializeColumnUsage(uint64 uEpoch, u16fast uFirstColumn, u16fast uColumnCount);
+#endif
+
+    // Runs the periodic maintenance of under-used columns, once every (1 << uPeriodLog2) epochs: either on the slice of the
+    //   columns matching current epoch within that period, or on all columns when epoch is at 'uBurstPhase' in burst mode.
+    void _onMaintainUnderUsedColumns(u8fast uPeriodLog2, uint64 uBurstPhase);
+
+    // Will increase all synaptic permanence values on columns in range which are deemed under-used
+    void _onIncreasePermanencesForUnderUsedColums(u16fast uFirstColumn, u16fast uColumnCount);
+
+    // Implements _onIncreasePermanencesForUnderUsedColums() for a single column. Only touches the segment and connectivity
+    //   field of that column, except for the inverted index as in _updateSynapsesOnColumnTowardsCurrentInput(). Rerolls, if
+    //   allowed, draw from a generator seeded from the current epoch and 'uColumnIndex' alone, so that results do not depend
+    //   on the order in which columns are processed.
+    //   Returns 1 if the potential pool of that column was fully redrawn, 2 if partially, 0 otherwise.
+    u8fast _onIncreasePermanencesForUnderUsedColumn(u16fast uColumnIndex, uint32** ppDeferredIndexUpdates);
+
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    // Implements _onIncreasePermanencesForUnderUsedColums() when parallel mode is on: one task per column, by batches
+    //   fitting in the deferred index update buffers, if needed. Adds to the pointed-to counters as the above returns.
+    void _onIncreasePermanencesForUnderUsedColumsInParallel(u16fast uFirstColumn, u16fast uColumnCount,
+        u16fast* pRedrawCount, u16fast* pSemiRedrawCount);
+#endif
 
     // Will compute the OverThresholdRatio which a column shall strive to reach or exceed, for all columns, based on
     //   neighboring columns usage
@@ -567,13 +916,44 @@ private:
 
     uint64* _pTmpBinaryInputBuffer;
     uint64* _pTmpBinaryOutputBuffer;
+    std::vector<uint16> _vecTmpOutputIndices;       // active indices if not provided by caller (reserved for the whole sheet)
 
     // Other bitfield buffers
 
     uint64* _pTmpBinaryOverThresholdActivations;
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-    uint64* _pConnectivityFields;                   // ... here one such bitfield for each minicolumn !
-    size_t  _uConnectivityFieldsQwordSizePerColumn;
+    uint16* _pTmpBatchActivationLevels;             // activation levels for a whole tile of inputs in batched inference
+    uint32* _pTmpBatchActiveQwordOffsets;           // compacted lists of non-zero qwords for a whole tile of inputs (offsets)
+    uint64* _pTmpBatchActiveQwordValues;            // compacted lists of non-zero qwords for a whole tile of inputs (values)
+    size_t* _pTmpBatchActiveQwordCounts;            // ... and their count, per input of the tile
+    size_t  _uBatchFieldsBlockColumnCount;          // number of columns whose fields fit in VANILLA_SP_BATCH_FIELDS_BLOCK_BYTES
+#endif
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    uint32* _pInvertedIndexStartPerCell;            // start offsets of the per-cell lists, sized by max possible fan-out
+    uint16* _pInvertedIndexCountPerCell;            // current count of connected columns for each presynaptic cell
+    uint16* _pInvertedIndexColumns;                 // ... and the lists themselves, of (col-major) column indices
+    uint32  _uInvertedIndexColumnsCapacity;         // allocated size of the above
+    uint64  _uInvertedIndexTotalCount;              // sum of all the above counts => total number of connected synapses
+    uint64* _pStreamingPreviousInput;               // previous input, when in streaming mode
+    bool    _bStreamingMode;                        // whether streaming mode is currently on
+    bool    _bStreamingStateValid;                  // whether previous input and raw levels can be used for next update
+#endif
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    uint32* _pTmpDeferredIndexUpdates;              // inverted index updates recorded by each active column in parallel mode
+    uint16* _pTmpDeferredIndexUpdatesCount;         // ... and their count per active column
+    size_t  _uDeferredIndexUpdatesCapacity;         // number of active columns the two above can currently hold
+#  endif
+#endif
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED16)
+    UpdatePermanences16Func _pUpdatePermanencesFunc; // synapse learning kernel, chosen at construction from CPU features
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8)
+    UpdatePermanences8Func _pUpdatePermanencesFunc;  // synapse learning kernel, chosen at construction from CPU features
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    UpdateBitSlicedPermanencesFunc _pUpdatePermanencesFunc; // synapse learning kernel, chosen at construction from CPU features
+    uint64* _pPotentialFields;                      // potential pool of each column, laid out as its connectivity field
+    uint64* _pPermanencePlanes;                     // 8 planes of permanence bits per column (lsb first), each laid out as
+                                                    //   its connectivity field
 #endif
 
     // Other temporary buffers and one-per-column tables
@@ -581,33 +961,34 @@ private:
     uint16* _pTmpRawActivationLevelsPerCol;
 #ifdef VANILLA_SP_USE_BOOSTING
     uint32* _pTmpBoostedActivationLevelsPerCol;
-    uint16* _pBoostingPerCol;
 #endif
     float* _pAverageOverThresholdRatioPerColumn;
     float* _pAverageActiveRatioPerColumn;
     float* _pOverThresholdRatioTargetPerColumn;
     uint32* _pInactiveEpochsPerColumn;
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    uint64* _pOverThresholdRatioEpochPerColumn;     // learning epoch up to which each of the two averages above was
+    uint64* _pActiveRatioEpochPerColumn;            //   integrated, for each column (@see VANILLA_SP_USE_LAZY_COLUMN_USAGE)
+#endif
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+    float* _pTmpMaxFilterValues;                    // G and RevH tables along Y, then along X, for the neighborhood max filter
+#  endif
+#endif
 
     // Properties from constructor params
 
-    uint8 _uPotentialConnectivityRadius;
-    uint8 _uInhibitionRadius;
-    uint8 _uInhibitionSideSize;
-    uint8 _uInputSheetsCount;
     float _fOverThresholdTargetVsMaxRatio;
     float _fActivationDensityRatio;
 
     float _fPotentialConnectivityRatio;
-    // additional properties for when bucket inhib mode is selected
-    uint8 _uBucketSize;
-    uint8 _uBucketCountY;
 
     uint64 _uColumnUsageIntegrationWindow;
+    bool _bUnderUsedColumnsBurstMode;   // whether under-used columns maintenance visits all columns at once
 
     // Misc.
 
-    uint32* _pTmpTableBest;
-    size_t _uCurrentWinnerK;
+    VanillaSPScratch _scratch;      // temporary buffers for selecting active columns
     uint64 _uEpoch;
     uint64 _uEpochLearning;
 
@@ -615,6 +996,100 @@ private:
     Segment* _pSegments;            //  (one per minicolumn)
 };
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP class
+// - - - - - - - - - - - - - - - - - - - -
+// Immutable, inference-only snapshot of a trained VanillaSP. Holds only connectivity fields (plus boost factors, if boosting
+//   is used) and inhibition parameters, and none of the permanences, usage averages or learning buffers.
+// Its 'compute' methods are const and reentrant: all temporaries are held by a 'Context' instead, to be owned by each of the
+//   calling threads, so that many threads may serve a single FrozenVanillaSP. Results are the same as the ones the frozen
+//   VanillaSP would have given at the time of freezing, for 'compute' with bLearning = false.
+// - - - - - - - - - - - - - - - - - - - -
+class FrozenVanillaSP : private VanillaSPInferenceCore {
+public:
+
+    // Only available Ctor: copies the current inference state of 'trainedSP'
+    FrozenVanillaSP(const VanillaSP& trainedSP);
+
+    // Dtor...
+    ~FrozenVanillaSP();
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Per-thread temporary buffers for calling 'compute' on a FrozenVanillaSP.
+    //   A Context may be reused across calls (and across FrozenVanillaSPs with same number of input sheets),
+    //   however never used by two threads at the same time.
+    // - - - - - - - - - - - - - - - - - - - -
+    struct Context {
+        Context(const FrozenVanillaSP& frozenSP);
+        ~Context();
+
+        VanillaSPScratch _scratch;
+        uint64* _pTmpBinaryInputBuffer;
+        uint64* _pTmpBinaryOutputBuffer;
+        uint16* _pTmpRawActivationLevelsPerCol;
+#ifdef VANILLA_SP_USE_BOOSTING
+        uint32* _pTmpBoostedActivationLevelsPerCol;
+#endif
+        std::vector<uint16> _vecTmpOutputIndices;   // reserved for the whole sheet
+    };
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Same as VanillaSP::compute() with bLearning = false, against input indices.
+    // - - - - - - - - - - - - - - - - - - - -
+    void compute(Context& context, const std::vector<uint16>& vecInputIndices, std::vector<uint16>& vecOutputIndices,
+        uint64* pOutputBinaryBitmap = 0, uint32* pOutputMinActivations = 0) const {
+        SDRTools::toBinaryBitmap64(vecInputIndices, context._pTmpBinaryInputBuffer,
+            size_t(_uInputSheetsCount) * VANILLA_HTM_SHEET_BYTES_BINARY);
+        _compute(context, context._pTmpBinaryInputBuffer, vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Same as VanillaSP::compute() with bLearning = false, against an input presented in bitfield-form.
+    // - - - - - - - - - - - - - - - - - - - -
+    void compute(Context& context, const uint64* pInputBinaryBitmap, std::vector<uint16>& vecOutputIndices,
+        uint64* pOutputBinaryBitmap = 0, uint32* pOutputMinActivations = 0) const {
+        _compute(context, pInputBinaryBitmap, vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations);
+    }
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Allocation-free signature, @see the one of VanillaSP::compute() with same parameters
+    // - - - - - - - - - - - - - - - - - - - -
+    size_t compute(Context& context, const uint64* pInputBinaryBitmap, uint16* pOutputIndices, size_t uOutputCapacity,
+        uint64* pOutputBinaryBitmap = 0, uint32* pOutputMinActivations = 0) const {
+        _compute(context, pInputBinaryBitmap, context._vecTmpOutputIndices, pOutputBinaryBitmap, pOutputMinActivations);
+        size_t uActiveCount = context._vecTmpOutputIndices.size();
+        memcpy((void*)pOutputIndices, context._vecTmpOutputIndices.data(),
+            std::min(uActiveCount, uOutputCapacity) * sizeof(uint16));
+        return uActiveCount;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Returns the number of input sheets expected by this SP
+    // - - - - - - - - - - - - - - - - - - - -
+    uint8 getInputSheetsCount() const { return _uInputSheetsCount; }
+
+    // - - - - - - - - - - - - - - - - - - - -
+    // Returns the boost factors which were frozen, @see VanillaSP::getBoostingFactors()
+    // Warning: May return null if boosting ain't specified for this implementation
+    // - - - - - - - - - - - - - - - - - - - -
+    const uint16* getBoostingFactors() const {
+#ifdef VANILLA_SP_USE_BOOSTING
+        return _pBoostingPerCol;
+#else
+        return 0;
+#endif
+    }
+
+private:
+    // Implements the public 'compute' interfaces above.
+    void _compute(Context& context, const uint64* pInputBinaryBitmap, std::vector<uint16>& vecOutputIndices,
+        uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations) const;
+};
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
 #if defined(VANILLA_SP_SUBNAMESPACE)
     } // namespace VANILLA_SP_SUBNAMESPACE
 #endif
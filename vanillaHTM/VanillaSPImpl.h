@@ -46,9 +46,12 @@
 #include "tools/system.h"
 #include "tools/bittools.h"
 #include "tools/rand.h"
+#include "tools/simd.h"
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <functional>
 
 //#define VANILLA_SP_DEBUG        1
 //#define VANILLA_SP_TRACE_STATS  1
@@ -62,6 +65,8 @@ namespace HTMATCH {
     namespace VANILLA_SP_SUBNAMESPACE {
 #endif
 
+#ifndef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+
 // - - - - - - - - - - - - - - - - - - - -
 // Updates a floating-point buffer of moving-averages used in vanilla SP across all columns in the sheet,
 //   integrating a new binary value, over 'IntegrationWindow' runs
@@ -83,6 +88,73 @@ static void _integrateBinaryFieldToMovingAverages(float* pColMajorMovingAverages
     }
 }
 
+#else // VANILLA_SP_USE_LAZY_COLUMN_USAGE
+
+// - - - - - - - - - - - - - - - - - - - -
+// Returns the factor by which a moving average as above gets multiplied, when integrating zeroes during all learning epochs
+//   from 'uFromEpoch' (included) to 'uToEpoch' (excluded), the window at epoch e being min(uIntegrationWindow, e+1).
+//   Epochs still within warm-up telescope (product of e/(e+1) is 'uFromEpoch' over warm-up end), others decay geometrically.
+// - - - - - - - - - - - - - - - - - - - -
+static float _getMovingAverageDecay(uint64 uFromEpoch, uint64 uToEpoch, uint64 uIntegrationWindow)
+{
+    uint64 uWarmupEnd = std::min(uToEpoch, std::max(uFromEpoch, uIntegrationWindow - 1u));
+    double fDecay = 1.0;
+    if (uWarmupEnd > uFromEpoch)
+        fDecay = double(uFromEpoch) / double(uWarmupEnd);
+    if (uToEpoch > uWarmupEnd)
+        fDecay *= std::pow(double(uIntegrationWindow - 1u) / double(uIntegrationWindow), double(uToEpoch - uWarmupEnd));
+    return float(fDecay);
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Same as _integrateBinaryFieldToMovingAverages() at learning epoch 'uEpoch', yet only touching the columns having their bit
+//   set: those first catch up with the decay they missed since the epoch recorded for them in 'pIntegratedUpToEpochs'.
+// - - - - - - - - - - - - - - - - - - - -
+static void _integrateBinaryFieldToMovingAveragesLazily(float* pColMajorMovingAverages, uint64* pIntegratedUpToEpochs,
+    const uint64* pBinaryBitmap, uint64 uEpoch, uint64 uIntegrationWindow)
+{
+    const float fIntegrationWindow = float(std::min(uIntegrationWindow, uEpoch + 1u));
+    const float fInvWindow = 1.0f / fIntegrationWindow;
+    const float fWindowMinusOne = fIntegrationWindow - 1.0f;
+    for (size_t uQword = 0u; uQword < (VANILLA_HTM_SHEET_2DSIZE >> 6u); uQword++) {
+        uint64 uBits = pBinaryBitmap[uQword];
+        while (uBits) {
+            size_t uIndex = (uQword << 6u) + size_t(getTrailingZeroesCount64(uBits));
+            uBits &= uBits - 1uLL;
+            float fPrevValue = pColMajorMovingAverages[uIndex];
+            if (pIntegratedUpToEpochs[uIndex] < uEpoch)
+                fPrevValue *= _getMovingAverageDecay(pIntegratedUpToEpochs[uIndex], uEpoch, uIntegrationWindow);
+            pColMajorMovingAverages[uIndex] = (fPrevValue * fWindowMinusOne + 1.0f) * fInvWindow;
+            pIntegratedUpToEpochs[uIndex] = uEpoch + 1u;
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Brings moving averages of a buffer as above up to learning epoch 'uEpoch', for columns in range. Columns which were last
+//   updated at the same epoch (most of them, typically) share the same decay factor.
+// - - - - - - - - - - - - - - - - - - - -
+static void _catchUpMovingAverages(float* pColMajorMovingAverages, uint64* pIntegratedUpToEpochs, uint64 uEpoch,
+    uint64 uIntegrationWindow, size_t uFirstColumn, size_t uColumnCount)
+{
+    uint64 uLastFromEpoch = uEpoch;
+    float fLastDecay = 1.0f;
+    for (size_t uIndex = uFirstColumn; uIndex < uFirstColumn + uColumnCount; uIndex++) {
+        uint64 uFromEpoch = pIntegratedUpToEpochs[uIndex];
+        if (uFromEpoch < uEpoch) {
+            if (uFromEpoch != uLastFromEpoch) {
+                fLastDecay = _getMovingAverageDecay(uFromEpoch, uEpoch, uIntegrationWindow);
+                uLastFromEpoch = uFromEpoch;
+            }
+            pColMajorMovingAverages[uIndex] *= fLastDecay;
+            pIntegratedUpToEpochs[uIndex] = uEpoch;
+        }
+    }
+}
+
+#endif // VANILLA_SP_USE_LAZY_COLUMN_USAGE
+
+#if (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
 // - - - - - - - - - - - - - - - - - - - -
 // Returns an updated synaptic permanence value, knowing previous permanence and signed delta to apply
 // Will be implemented differently based on the current 'VANILLA_SP_SYNAPSE_KIND' option
@@ -123,10 +195,12 @@ static VANILLA_SP_SYN_PERM_TYPE _increasePermanence(VANILLA_SP_SYN_PERM_TYPE pre
     return VANILLA_SP_SYN_PERM_TYPE(iNow);
 #endif
 }
+#endif // !VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8
 
+#if defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
 // - - - - - - - - - - - - - - - - - - - -
 // Returns an updated synaptic permanence value, knowing previous permanence and unsigned decrease to apply
-// Will be implemented differently based on the current 'VANILLA_SP_SYNAPSE_KIND' option
+// (fixed-point kinds rather decrease through the vectorized learning kernel)
 // - - - - - - - - - - - - - - - - - - - -
 static VANILLA_SP_SYN_PERM_TYPE _decreasePermanence(VANILLA_SP_SYN_PERM_TYPE previousPermanence,
     VANILLA_SP_SYN_PERM_TYPE unsignedPermanenceDecrease)
@@ -143,6 +217,7 @@ static VANILLA_SP_SYN_PERM_TYPE _decreasePermanence(VANILLA_SP_SYN_PERM_TYPE pre
     return VANILLA_SP_SYN_PERM_TYPE(iNow);
 #endif
 }
+#endif
 
 // - - - - - - - - - - - - - - - - - - - -
 // Helper method for implementing _getBestFromRange() below
@@ -166,17 +241,28 @@ static u16fast _insertInQueue(uint32* pQueue, uint32 uValueToInsert, u16fast uIn
 }
 
 // - - - - - - - - - - - - - - - - - - - -
-// Fills a table of 'uWinnerK+1' best values found in a rectangular region on the cortical sheet,
-//   typically from either Raw or Boosted 'ActivationLevel' values. Raw levels are typically 16b, and boosted levels are
-//     typically 32b, but algorithm is same between the two (thus specifying 'ActivationLevelType' template parameter)
-//   bCareForXWrap must be specified true whenever uStartX+uSizeX > VANILLA_SP_SHEET_WIDTH,
-//   bCareForYWrap must be specified true whenever uStartY+uSizeY > VANILLA_SP_SHEET_HEIGHT,
-// However, chosing between them is left to user discretion as various algorithms are able to ensure they won't get out of bounds
-//   for one or the other beforehand, and them being template parameters will allow an overhead-free conditional implementation.
+// Inserts a value known to be above current tail value in a queue of best values, keeping it sorted
+//   (helper method for _getBestFromRange() below, and for bucket inhibition)
 // - - - - - - - - - - - - - - - - - - - -
-template<typename ActivationLevelType, bool bCareForXWrap, bool bCareForYWrap>
-static u16fast _getBestFromRange(u16fast uStartX, u16fast uSizeX, u16fast uStartY, u16fast uSizeY,
-    const ActivationLevelType* pColMajorActivationLevels, uint32* pQueueOfBestValues, u16fast uQueueCapacity)
+FORCE_INLINE static u16fast _insertInQueueOfBest(uint32* pQueue, uint32 uValueToInsert, u16fast uQueueCapacity,
+    u16fast uQueueSize, uint32* ioCurrentTailValue) FORCE_INLINE_END
+{
+    // reverse-iterating the queue to find a correct insert position (we want to insert keeping the queue sorted)
+    for (u16fast uIndexIn = uQueueSize-1u; uIndexIn; uIndexIn--) {
+        // checking value just before to check if we're greater
+        if (pQueue[uIndexIn-1] >= uValueToInsert) // found greater predecessor => insert right there
+            return _insertInQueue(pQueue, uValueToInsert, uIndexIn, uQueueCapacity, uQueueSize, ioCurrentTailValue);
+    }
+    // If we did not find a greater predecessor checking the full queue, it means we should insert to head of queue
+    return _insertInQueue(pQueue, uValueToInsert, 0u, uQueueCapacity, uQueueSize, ioCurrentTailValue);
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Returns the value just below stimulus threshold for either Raw or Boosted 'ActivationLevel' values, which neighborhood
+//   best searches use as tail value of their queues (levels not above it are never considered)
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType>
+static uint32 _getBelowStimulusThreshold()
 {
     uint32 uLowestIn = 0u;
     if (VANILLA_SP_DEFAULT_STIMULUS_THRESHOLD > 0) {
@@ -188,6 +274,89 @@ static u16fast _getBestFromRange(u16fast uStartX, u16fast uSizeX, u16fast uStart
 #endif
         uLowestIn = uStimThresholdPossiblyBoosted - 1u;
     }
+    return uLowestIn;
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Finds, over the whole sheet, the same value to beat as _getBestFromRange() would have left at index 'count' of its table
+//   with a capacity of 'uWinnerK+1' (that is, the (K+1)th best level among those above stimulus threshold, or the value just
+//   below that threshold if there are not that many), and returns that same count... only without any sorted queue:
+//   levels are counted per digit made of their VANILLA_SP_RADIX_SELECT_DIGIT_BITS most significant bits (relative to the max
+//   level found), which tells the digit of the level we're after, and how many levels are above that digit. Raw levels,
+//   bounded by synapse count per segment, are exactly their digit (this is then a mere counting select) ; boosted levels
+//   rather get a second pass, collecting the few ones sharing that digit, among which the level we're after is then found
+//   by a partial sort.
+// - - - - - - - - - - - - - - - - - - - -
+#define VANILLA_SP_RADIX_SELECT_DIGIT_BITS  11u
+
+template<typename ActivationLevelType>
+static u16fast _getBestThresholdFromWholeSheet(const ActivationLevelType* pActivationLevelsPerCol, u16fast uWinnerK,
+    uint16* pDigitCounts, uint32* pCandidates, uint32* pOutBelowMin)
+{
+    const uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
+    const ActivationLevelType* pEnd = pActivationLevelsPerCol + VANILLA_HTM_SHEET_2DSIZE;
+    u16fast uCountAbove = 0u;
+    uint32 uMaxLevel = 0u;
+    for (const ActivationLevelType* pCurrent = pActivationLevelsPerCol; pCurrent < pEnd; pCurrent++) {
+        uint32 uLevel = uint32(*pCurrent);
+        uCountAbove += u16fast(uLevel > uLowestIn);
+        uMaxLevel = std::max(uMaxLevel, uLevel);
+    }
+    *pOutBelowMin = uLowestIn;
+    if (uCountAbove <= uWinnerK)
+        return uCountAbove;
+
+    // Since there are more than K levels above uLowestIn, uMaxLevel is non-zero here
+    u8fast uLevelBits = u8fast(getMostSignificantBitPos32(uMaxLevel) + 1u);
+    u8fast uShift = uLevelBits > VANILLA_SP_RADIX_SELECT_DIGIT_BITS ? uLevelBits - VANILLA_SP_RADIX_SELECT_DIGIT_BITS : 0u;
+    uint32 uMaxDigit = uMaxLevel >> uShift;
+    std::fill(pDigitCounts, pDigitCounts + uMaxDigit + 1u, uint16(0u));
+    for (const ActivationLevelType* pCurrent = pActivationLevelsPerCol; pCurrent < pEnd; pCurrent++) {
+        pDigitCounts[uint32(*pCurrent) >> uShift]++;
+    }
+    // Levels not above uLowestIn were counted as well, but they can only pollute digits up to that of uLowestIn... and the
+    //   level we're after, being above uLowestIn, is necessarily at that digit if not found at any higher one.
+    u32fast uRemainingRank = u32fast(uWinnerK) + 1u;    // rank, from the top, of the level we're after
+    uint32 uLowestInDigit = uLowestIn >> uShift;
+    uint32 uDigit = uMaxDigit;
+    while (uDigit > uLowestInDigit && pDigitCounts[uDigit] < uRemainingRank) {
+        uRemainingRank -= pDigitCounts[uDigit];
+        uDigit--;
+    }
+    if (uShift) {
+        uint32 uDigitLowest = std::max(uDigit << uShift, uLowestIn + 1u);
+        uint32 uDigitSpan = ((uDigit << uShift) | ((1u << uShift) - 1u)) - uDigitLowest;
+        uint32* pEndCandidate = pCandidates;
+        for (const ActivationLevelType* pCurrent = pActivationLevelsPerCol; pCurrent < pEnd; pCurrent++) {
+            uint32 uLevel = uint32(*pCurrent);
+            if (uLevel - uDigitLowest <= uDigitSpan)    // single unsigned compare for being in range
+                *pEndCandidate++ = uLevel;
+        }
+        uint32* pNth = pCandidates + (uRemainingRank - 1u);
+        std::nth_element(pCandidates, pNth, pEndCandidate, std::greater<uint32>());
+        *pOutBelowMin = *pNth;
+    } else {
+        *pOutBelowMin = uDigit;
+    }
+    return uWinnerK;
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Fills a table of 'uWinnerK+1' best values found in a rectangular region on the cortical sheet,
+//   typically from either Raw or Boosted 'ActivationLevel' values. Raw levels are typically 16b, and boosted levels are
+//     typically 32b, but algorithm is same between the two (thus specifying 'ActivationLevelType' template parameter)
+//   bCareForXWrap must be specified true whenever uStartX+uSizeX > VANILLA_SP_SHEET_WIDTH,
+//   bCareForYWrap must be specified true whenever uStartY+uSizeY > VANILLA_SP_SHEET_HEIGHT,
+// However, chosing between them is left to user discretion as various algorithms are able to ensure they won't get out of bounds
+//   for one or the other beforehand, and them being template parameters will allow an overhead-free conditional implementation.
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType, bool bCareForXWrap, bool bCareForYWrap>
+static u16fast _getBestFromRange(u16fast uStartX, u16fast uSizeX, u16fast uStartY, u16fast uSizeY,
+    const ActivationLevelType* pColMajorActivationLevels, uint32* pQueueOfBestValues, u16fast uQueueCapacity)
+{
+    uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
     // inserts one less-than activation threshold as tail value.
     pQueueOfBestValues[0] = uLowestIn;
     u16fast uQueueSize = 1u;
@@ -201,20 +370,7 @@ static u16fast _getBestFromRange(u16fast uStartX, u16fast uSizeX, u16fast uStart
             ActivationLevelType uActivationLevel = pColMajorActivationLevels[uIndex];
             // We only need to consider inserting that value if we're greater than the know tail of the queue
             if (uActivationLevel > uLowestIn) { // (will be at least the activation threshold if queue is not yet full)
-                bool bInserted = false;
-                // reverse-iterating the queue to find a correct insert position (we want to insert keeping the queue sorted)
-                for (u16fast uIndexIn = uQueueSize-1u; uIndexIn; uIndexIn--) {
-                    // checking value just before to check if we're greater 
-                    if (pQueueOfBestValues[uIndexIn-1] >= uActivationLevel) { // found greater predecessor => insert right there
-                        uQueueSize = _insertInQueue(pQueueOfBestValues, uActivationLevel, uIndexIn, uQueueCapacity, uQueueSize, &uLowestIn);
-                        bInserted = true;
-                        break;
-                    }
-                }
-                // If we did not find a greater predecessor checking the full queue, it means we should insert to head of queue
-                if (!bInserted) {
-                    uQueueSize = _insertInQueue(pQueueOfBestValues, uActivationLevel, 0u, uQueueCapacity, uQueueSize, &uLowestIn);
-                }
+                uQueueSize = _insertInQueueOfBest(pQueueOfBestValues, uActivationLevel, uQueueCapacity, uQueueSize, &uLowestIn);
             }
         }
     }
@@ -294,6 +450,28 @@ static float _getMaxFromRange(u16fast uStartX, u16fast uSizeX, u16fast uStartY,
 }
 ; // template termination
 
+// - - - - - - - - - - - - - - - - - - - -
+// Computes the partition of a (wrapped) line of uSideSize positions into kernels of size (2*uRadius + 1), aligned
+//   at multiples of the kernel size from position 0, as expected by the G and RevH helpers below.
+// Kernel count is the number of full kernels before sheet end ; remainder the number of positions of the next one
+//   before sheet end ; after-remainder the number of positions of that same kernel once wrapped around, up to
+//   uRadius ; last kernel size the count of positions of yet another (wrapped) kernel up to sheetSize + uRadius.
+// - - - - - - - - - - - - - - - - - - - -
+static void _computeOptiKernelPartition(u8fast uRadius, u8fast uSideSize, u8fast& uKernelSize, u8fast& uKernelCount,
+    u8fast& uRemainder, u8fast& uAfterRemainder, u8fast& uLastKernelSize)
+{
+    uKernelSize = uRadius * 2u + 1u;
+    uKernelCount = uSideSize / uKernelSize;
+    uRemainder = uSideSize % uKernelSize;
+    uAfterRemainder = uKernelSize - uRemainder;
+    uLastKernelSize = 0u;
+    if (uAfterRemainder >= uRadius) {
+        uAfterRemainder = uRadius;
+    } else {
+        uLastKernelSize = uRadius - uAfterRemainder;
+    }
+}
+
 // - - - - - - - - - - - - - - - - - - - -
 // One of the helper-methods for implementing a very-optimized sum or max filter over a rectangular kernel.
 // @see _computeOptiForSum, _computeOptiForMax, _computeOptiForBest
@@ -359,12 +537,52 @@ static void _computeRowMajorGFromColMajorValues(const ValType* pColumnValues, Ou
 template<typename ValType, typename OutType, typename InitFunc, typename IntegrationFunc>
 static void _computeRowMajorRevHFromColMajorValues(const ValType* pColumnValues, OutType* outRevH, InitFunc initializer,
     IntegrationFunc integrator, u8fast uRadius, u8fast uKernelSize, u8fast uKernelCount, u8fast uRemainderY,
-    u8fast uAfterRemainderY, u8fast uLastKernelSize)
+    u8fast uAfterRemainderY)
 {
-
-
-
-    // TODO
+    // Reverse integration over the same kernels as G, so that the full neighborhood of any Y is covered by
+    //   RevH at (Y - uRadius) and G at (Y + uRadius).
+    // => output will start offset by -uRadius, wrapping around to the tail of the column for the first uRadius of them
+    u8fast uSideSize = uKernelCount * uKernelSize + uRemainderY;
+    OutType integratedVal;
+    // start integration for the kernel straddling sheet end, from its wrapped part
+    initializer(integratedVal);
+    for (u8fast uRelY = uAfterRemainderY; uRelY > 0u; ) {
+        uRelY--;
+        integrator(integratedVal, pColumnValues[uRelY]);
+    }
+    const ValType* pInput = pColumnValues + uSideSize;
+    u8fast uLeftInKernel = uRemainderY;
+    u8fast uY = uSideSize;
+    // integrate values without emitting output, for the last "uRadius" positions before sheet height
+    for (; uY + uRadius > uSideSize; ) {
+        uY--; pInput--;
+        if (0u == uLeftInKernel) {
+            initializer(integratedVal);
+            uLeftInKernel = uKernelSize;
+        }
+        uLeftInKernel--;
+        integrator(integratedVal, *pInput);
+    }
+    // integrate values backwards and emit output, starting new integrations at each kernel start
+    OutType* pOutput = outRevH + size_t(uSideSize) * VANILLA_HTM_SHEET_WIDTH;
+    for (; uY > 0u; ) {
+        uY--; pInput--; pOutput -= VANILLA_HTM_SHEET_WIDTH;
+        if (0u == uLeftInKernel) {
+            initializer(integratedVal);
+            uLeftInKernel = uKernelSize;
+        }
+        uLeftInKernel--;
+        integrator(integratedVal, *pInput);
+        *pOutput = integratedVal;
+    }
+    // Wraps around for the first uRadius outputs, belonging to the kernel ending just before Y=0
+    initializer(integratedVal);
+    pInput = pColumnValues + uSideSize;
+    for (u8fast uRelY = 0u; uRelY < uRadius; uRelY++) {
+        pInput--; pOutput -= VANILLA_HTM_SHEET_WIDTH;
+        integrator(integratedVal, *pInput);
+        *pOutput = integratedVal;
+    }
 }
 ; // template termination
 
@@ -377,7 +595,48 @@ static void _computeColMajorGFromRowMajorGandH(const ValType* pRowGs, const ValT
     IntegrationFunc integrator, u8fast uRadius, u8fast uKernelSize, u8fast uKernelCount, u8fast uRemainderY,
     u8fast uAfterRemainderY, u8fast uLastKernelSize)
 {
-    // TODO
+    // Same as _computeRowMajorGFromColMajorValues, along X this time, where the value at each position is the integration
+    //   of both G and RevH from previous pass along Y
+    OutType integratedVal = startVal;
+    const ValType* pInputG = pRowGs;
+    const ValType* pInputRevH = pRowRevHs;
+    u8fast uRelX = 0u;
+    for (; uRelX < uRadius; uRelX++, pInputG++, pInputRevH++) {
+        integrator(integratedVal, *pInputG);
+        integrator(integratedVal, *pInputRevH);
+    }
+    for (; uRelX < uKernelSize; uRelX++, pInputG++, pInputRevH++, outG += VANILLA_HTM_SHEET_HEIGHT) {
+        integrator(integratedVal, *pInputG);
+        integrator(integratedVal, *pInputRevH);
+        *outG = integratedVal;
+    }
+    for (u8fast uK = 1u; uK < uKernelCount; uK++) {
+        integratedVal = startVal;
+        for (uRelX = 0u; uRelX < uKernelSize; uRelX++, pInputG++, pInputRevH++, outG += VANILLA_HTM_SHEET_HEIGHT) {
+            integrator(integratedVal, *pInputG);
+            integrator(integratedVal, *pInputRevH);
+            *outG = integratedVal;
+        }
+    }
+    integratedVal = startVal;
+    for (uRelX = 0u; uRelX < uRemainderY; uRelX++, pInputG++, pInputRevH++, outG += VANILLA_HTM_SHEET_HEIGHT) {
+        integrator(integratedVal, *pInputG);
+        integrator(integratedVal, *pInputRevH);
+        *outG = integratedVal;
+    }
+    pInputG = pRowGs;
+    pInputRevH = pRowRevHs;
+    for (uRelX = 0u; uRelX < uAfterRemainderY; uRelX++, pInputG++, pInputRevH++, outG += VANILLA_HTM_SHEET_HEIGHT) {
+        integrator(integratedVal, *pInputG);
+        integrator(integratedVal, *pInputRevH);
+        *outG = integratedVal;
+    }
+    integratedVal = startVal;
+    for (uRelX = 0u; uRelX < uLastKernelSize; uRelX++, pInputG++, pInputRevH++, outG += VANILLA_HTM_SHEET_HEIGHT) {
+        integrator(integratedVal, *pInputG);
+        integrator(integratedVal, *pInputRevH);
+        *outG = integratedVal;
+    }
 }
 ; // template termination
 
@@ -388,9 +647,48 @@ static void _computeColMajorGFromRowMajorGandH(const ValType* pRowGs, const ValT
 template<typename ValType, typename OutType, typename IntegrationFunc>
 static void _computeColMajorRevHFromRowMajorGandH(const ValType* pRowGs, const ValType* pRowRevHs, OutType* outRevH,
     OutType startVal, IntegrationFunc integrator, u8fast uRadius, u8fast uKernelSize, u8fast uKernelCount, u8fast uRemainderY,
-    u8fast uAfterRemainderY, u8fast uLastKernelSize)
+    u8fast uAfterRemainderY)
 {
-    // TODO
+    // Same as _computeRowMajorRevHFromColMajorValues, along X this time, where the value at each position is the integration
+    //   of both G and RevH from previous pass along Y
+    u8fast uSideSize = uKernelCount * uKernelSize + uRemainderY;
+    OutType integratedVal = startVal;
+    for (u8fast uRelX = uAfterRemainderY; uRelX > 0u; ) {
+        uRelX--;
+        integrator(integratedVal, pRowGs[uRelX]);
+        integrator(integratedVal, pRowRevHs[uRelX]);
+    }
+    u8fast uLeftInKernel = uRemainderY;
+    u8fast uX = uSideSize;
+    for (; uX + uRadius > uSideSize; ) {
+        uX--;
+        if (0u == uLeftInKernel) {
+            integratedVal = startVal;
+            uLeftInKernel = uKernelSize;
+        }
+        uLeftInKernel--;
+        integrator(integratedVal, pRowGs[uX]);
+        integrator(integratedVal, pRowRevHs[uX]);
+    }
+    OutType* pOutput = outRevH + size_t(uSideSize) * VANILLA_HTM_SHEET_HEIGHT;
+    for (; uX > 0u; ) {
+        uX--; pOutput -= VANILLA_HTM_SHEET_HEIGHT;
+        if (0u == uLeftInKernel) {
+            integratedVal = startVal;
+            uLeftInKernel = uKernelSize;
+        }
+        uLeftInKernel--;
+        integrator(integratedVal, pRowGs[uX]);
+        integrator(integratedVal, pRowRevHs[uX]);
+        *pOutput = integratedVal;
+    }
+    integratedVal = startVal;
+    for (u8fast uRelX = 0u; uRelX < uRadius; uRelX++) {
+        pOutput -= VANILLA_HTM_SHEET_HEIGHT;
+        integrator(integratedVal, pRowGs[uSideSize - 1u - uRelX]);
+        integrator(integratedVal, pRowRevHs[uSideSize - 1u - uRelX]);
+        *pOutput = integratedVal;
+    }
 }
 ; // template termination
 
@@ -444,68 +742,338 @@ static void _computeOptiForSumX(const ValTypeSum* pRowMajSumYG, const ValTypeSum
 
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
+// Max over the (2*uRadius + 1)-sided neighborhood of a column, from the G and RevH tables at that column index, as
+//   output by _computeOptiForMaxX. Those are already aligned to the column by the helpers, hence no offset here.
+// - - - - - - - - - - - - - - - - - - - -
 template<typename ValType>
-static ValType _computeMaxFromOpti(const ValType* pCurrentColMajMaxXG, const ValType* pCurrentColMajMaxXRevH, u8fast uRadius)
+static ValType _computeMaxFromOpti(const ValType* pCurrentColMajMaxXG, const ValType* pCurrentColMajMaxXRevH)
 {
-    // TODO
+    return std::max(*pCurrentColMajMaxXG, *pCurrentColMajMaxXRevH);
 }
 ; // template termination
 
 // - - - - - - - - - - - - - - - - - - - -
+// First pass of the max filter, along (wrapped) Y for each X. Cost per column does not depend on uRadius.
+// uRadius is expected to be less than VANILLA_HTM_SHEET_HEIGHT/2.
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ValType>
 static void _computeOptiForMaxY(const ValType* pColMajValues, u8fast uRadius, ValType* pRowMajMaxYG, ValType* pRowMajMaxYRevH)
 {
-    u8fast uKernelSize = uRadius * 2u + 1u;
-    // TODO
+    u8fast uKernelSize, uKernelCountY, uRemainderY, uAfterRemainderY, uLastKernelSize;
+    _computeOptiKernelPartition(uRadius, VANILLA_HTM_SHEET_HEIGHT, uKernelSize, uKernelCountY, uRemainderY,
+        uAfterRemainderY, uLastKernelSize);
+    auto initializer = [](ValType& integratedVal) { integratedVal = std::numeric_limits<ValType>::lowest(); };
+    auto integrator = [](ValType& integratedVal, ValType inputVal) { integratedVal = std::max(integratedVal, inputVal); };
+    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
+        const ValType* pColumnValues = pColMajValues + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        _computeRowMajorGFromColMajorValues(pColumnValues, pRowMajMaxYG + uX, initializer, integrator,
+            uRadius, uKernelSize, uKernelCountY, uRemainderY, uAfterRemainderY, uLastKernelSize);
+        _computeRowMajorRevHFromColMajorValues(pColumnValues, pRowMajMaxYRevH + uX, initializer, integrator,
+            uRadius, uKernelSize, uKernelCountY, uRemainderY, uAfterRemainderY);
+    }
 }
 ; // template termination
 
 // - - - - - - - - - - - - - - - - - - - -
+// Second pass of the max filter, along (wrapped) X for each Y. Cost per column does not depend on uRadius.
+// uRadius is expected to be less than VANILLA_HTM_SHEET_WIDTH/2.
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ValType>
 static void _computeOptiForMaxX(const ValType* pRowMajMaxYG, const ValType* pRowMajMaxYRevH, u8fast uRadius,
     ValType* pColMajMaxXG, ValType* pColMajMaxXRevH)
 {
-    u8fast uKernelSize = uRadius * 2u + 1u;
-    // TODO
+    u8fast uKernelSize, uKernelCountX, uRemainderX, uAfterRemainderX, uLastKernelSize;
+    _computeOptiKernelPartition(uRadius, VANILLA_HTM_SHEET_WIDTH, uKernelSize, uKernelCountX, uRemainderX,
+        uAfterRemainderX, uLastKernelSize);
+    auto integrator = [](ValType& integratedVal, ValType inputVal) { integratedVal = std::max(integratedVal, inputVal); };
+    ValType startVal = std::numeric_limits<ValType>::lowest();
+    for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+        size_t uRowOffset = size_t(uY) << VANILLA_HTM_SHEET_SHIFT_DIVX;
+        _computeColMajorGFromRowMajorGandH(pRowMajMaxYG + uRowOffset, pRowMajMaxYRevH + uRowOffset, pColMajMaxXG + uY,
+            startVal, integrator, uRadius, uKernelSize, uKernelCountX, uRemainderX, uAfterRemainderX, uLastKernelSize);
+        _computeColMajorRevHFromRowMajorGandH(pRowMajMaxYG + uRowOffset, pRowMajMaxYRevH + uRowOffset, pColMajMaxXRevH + uY,
+            startVal, integrator, uRadius, uKernelSize, uKernelCountX, uRemainderX, uAfterRemainderX);
+    }
 }
 ; // template termination
 
+#if defined(VANILLA_SP_NEIGHBORHOOD_OPTIM) && (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
+
 // - - - - - - - - - - - - - - - - - - - -
 // Optimized k-best across neighborhood
 // - - - - - - - - - - - - - - - - - - - -
 
+// Here, G and RevH are no longer single values but lists of 'uListSize' best values, sorted in decreasing order and
+//   padded with a tail value (typically just below stimulus threshold) ; the k-best lists of two disjoint ranges can be
+//   merged into the k-best list of their union, which is all the van Herk scheme requires (as long as G and RevH at a
+//   same position do not overlap, unlike for max).
+// - - - - - - - - - - - - - - - - - - - -
+
 // - - - - - - - - - - - - - - - - - - - -
+// Inserts one value into a k-best list, if greater than its current tail
 // - - - - - - - - - - - - - - - - - - - -
-template<typename ValType>
-static size_t _computeKBestFromOpti(const ValType* pCurrentColMajBestXG, const ValType* pCurrentColMajBestXRevH, u8fast uRadius,
-    u8fast uMaxK)
+static void _insertInKBestList(uint32* pList, u16fast uListSize, uint32 uValue)
 {
-    // TODO
+    u16fast uPos = uListSize - 1u;
+    if (uValue > pList[uPos]) {
+        for (; uPos && pList[uPos - 1u] < uValue; uPos--) {
+            pList[uPos] = pList[uPos - 1u];
+        }
+        pList[uPos] = uValue;
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Merges two k-best lists into a third one (which shall not alias either of them)
+// - - - - - - - - - - - - - - - - - - - -
+static void _mergeKBestLists(const uint32* pListA, const uint32* pListB, u16fast uListSize, uint32* pOutList)
+{
+    const uint32* pEndOut = pOutList + uListSize;
+    for (; pOutList < pEndOut; pOutList++) {
+        if (*pListA >= *pListB) {
+            *pOutList = *pListA;
+            pListA++;
+        } else {
+            *pOutList = *pListB;
+            pListB++;
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Merges a k-best list into another one, in place, using 'pTmpList' as temporary storage
+// - - - - - - - - - - - - - - - - - - - -
+static void _mergeInKBestList(uint32* pList, const uint32* pOtherList, u16fast uListSize, uint32* pTmpList)
+{
+    if (pOtherList[0] > pList[uListSize - 1u]) {   // otherwise, other list has nothing to contribute
+        _mergeKBestLists(pList, pOtherList, uListSize, pTmpList);
+        std::copy(pTmpList, pTmpList + uListSize, pList);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Runs both the forward (G) and reverse (RevH) integrations of k-best lists along one wrapped line of 'uSideSize' positions,
+//   with kernels of size (2*uRadius + 1) aligned at multiples of the kernel size from position 0, as for the max filter.
+// Output lists for a position i are written at (i * uOutStride), so that the neighborhood of i is covered by the union of
+//   G and RevH there. 'integrateAt(pList, uPos)' shall integrate the input at position uPos into pList.
+// uRadius is expected to be less than uSideSize/2.
+// - - - - - - - - - - - - - - - - - - - -
+template<typename IntegrationFunc>
+static void _computeKBestGandRevHAlongLine(u8fast uRadius, i16fast iSideSize, IntegrationFunc integrateAt,
+    uint32* pOutG, uint32* pOutRevH, size_t uOutStride, u16fast uListSize, uint32 uLowestIn)
+{
+    uint32 pAccList[VANILLA_SP_MAX_WINNERS + 1u];
+    i16fast iRadius = i16fast(uRadius);
+    i16fast iKernelSize = iRadius * 2 + 1;
+    // forward integration over positions [0, side + radius), wrapped, emitting at (pos - radius)
+    for (i16fast iPos = 0; iPos < iSideSize + iRadius; iPos++) {
+        if (0 == iPos % iKernelSize) {
+            std::fill(pAccList, pAccList + uListSize, uLowestIn);
+        }
+        integrateAt(pAccList, u16fast(iPos < iSideSize ? iPos : iPos - iSideSize));
+        if (iPos >= iRadius) {
+            uint32* pOutList = pOutG + size_t(iPos - iRadius) * uOutStride;
+            if (0 == (iPos + 1) % iKernelSize) {
+                // neighborhood coincides with the kernel there, already fully integrated in RevH => G shall not repeat it
+                std::fill(pOutList, pOutList + uListSize, uLowestIn);
+            } else {
+                std::copy(pAccList, pAccList + uListSize, pOutList);
+            }
+        }
+    }
+    // reverse integration over positions [-radius, side - radius), wrapped, emitting at (pos + radius)
+    //   => starting from the end of the kernel holding (side - radius - 1), which is at most (side + radius - 1)
+    for (i16fast iPos = iSideSize + iRadius - 1; iPos >= -iRadius; iPos--) {
+        if (0 == (iPos + 1 + iKernelSize) % iKernelSize || iPos == iSideSize + iRadius - 1) {
+            std::fill(pAccList, pAccList + uListSize, uLowestIn);
+        }
+        integrateAt(pAccList, u16fast(iPos < 0 ? iPos + iSideSize : (iPos < iSideSize ? iPos : iPos - iSideSize)));
+        if (iPos < iSideSize - iRadius) {
+            std::copy(pAccList, pAccList + uListSize, pOutRevH + size_t(iPos + iRadius) * uOutStride);
+        }
+    }
 }
 ; // template termination
 
 // - - - - - - - - - - - - - - - - - - - -
+// Merges the k-best lists from _computeOptiForKBestX at a column index into a queue of 'uListSize' best values, to be used
+//   the same way as the one filled by _getBestFromRange over the full neighborhood ; returns the same count.
+// - - - - - - - - - - - - - - - - - - - -
+static u16fast _computeKBestFromOpti(const uint32* pCurrentColMajBestXG, const uint32* pCurrentColMajBestXRevH,
+    u16fast uListSize, uint32 uLowestIn, uint32* pQueueOfBestValues)
+{
+    _mergeKBestLists(pCurrentColMajBestXG, pCurrentColMajBestXRevH, uListSize, pQueueOfBestValues);
+    u16fast uCountBest = 0u;
+    u16fast uMaxCount = uListSize - 1u;
+    while (uCountBest < uMaxCount && pQueueOfBestValues[uCountBest] > uLowestIn)
+        uCountBest++;
+    return uCountBest;
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// First pass of the k-best filter, along (wrapped) Y for each X. Output lists are row-major, 'uListSize' values each.
+// uRadius is expected to be less than VANILLA_HTM_SHEET_HEIGHT/2.
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ValType>
 static void _computeOptiForKBestY(const ValType* pColMajValues, u8fast uRadius,
-    ValType* pRowMajBestYG, ValType* pRowMajBestYRevH, u8fast uMaxK)
+    uint32* pRowMajBestYG, uint32* pRowMajBestYRevH, u16fast uListSize, uint32 uLowestIn)
 {
-    // TODO
+    size_t uOutStride = size_t(uListSize) * VANILLA_HTM_SHEET_WIDTH;
+    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
+        const ValType* pColumnValues = pColMajValues + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        auto integrateAt = [pColumnValues, uListSize](uint32* pList, u16fast uY) {
+            _insertInKBestList(pList, uListSize, uint32(pColumnValues[uY]));
+        };
+        size_t uOutOffset = size_t(uX) * uListSize;
+        _computeKBestGandRevHAlongLine(uRadius, i16fast(VANILLA_HTM_SHEET_HEIGHT), integrateAt,
+            pRowMajBestYG + uOutOffset, pRowMajBestYRevH + uOutOffset, uOutStride, uListSize, uLowestIn);
+    }
 }
 ; // template termination
 
 // - - - - - - - - - - - - - - - - - - - -
+// Second pass of the k-best filter, along (wrapped) X for each Y. Output lists are column-major, 'uListSize' values each.
+// uRadius is expected to be less than VANILLA_HTM_SHEET_WIDTH/2.
 // - - - - - - - - - - - - - - - - - - - -
-template<typename ValType>
-static void _computeOptiForKBestX(const ValType* pRowMajBestYG, const ValType* pRowMajBestYRevH, u8fast uRadius,
-    ValType* pColMajBestXG, ValType* pColMajBestXRevH, u8fast uMaxK)
+static void _computeOptiForKBestX(const uint32* pRowMajBestYG, const uint32* pRowMajBestYRevH, u8fast uRadius,
+    uint32* pColMajBestXG, uint32* pColMajBestXRevH, u16fast uListSize, uint32 uLowestIn)
 {
-    // TODO
+    uint32 pTmpList[VANILLA_SP_MAX_WINNERS + 1u];
+    size_t uOutStride = size_t(uListSize) * VANILLA_HTM_SHEET_HEIGHT;
+    for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+        size_t uRowOffset = (size_t(uY) << VANILLA_HTM_SHEET_SHIFT_DIVX) * uListSize;
+        const uint32* pRowG = pRowMajBestYG + uRowOffset;
+        const uint32* pRowRevH = pRowMajBestYRevH + uRowOffset;
+        auto integrateAt = [pRowG, pRowRevH, uListSize, &pTmpList](uint32* pList, u16fast uX) {
+            size_t uListOffset = size_t(uX) * uListSize;
+            _mergeInKBestList(pList, pRowG + uListOffset, uListSize, pTmpList);
+            _mergeInKBestList(pList, pRowRevH + uListOffset, uListSize, pTmpList);
+        };
+        size_t uOutOffset = size_t(uY) * uListSize;
+        _computeKBestGandRevHAlongLine(uRadius, i16fast(VANILLA_HTM_SHEET_WIDTH), integrateAt,
+            pColMajBestXG + uOutOffset, pColMajBestXRevH + uOutOffset, uOutStride, uListSize, uLowestIn);
+    }
+}
+
+#endif // VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM
+
+#ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+
+// - - - - - - - - - - - - - - - - - - - -
+// Sliding-window histogram of activation levels, for k-best across neighborhood
+// - - - - - - - - - - - - - - - - - - - -
+// Levels not above stimulus threshold are never counted. Raw levels each get their own bin ; boosted (uint32) levels are
+//   quantised into the same number of bins, in a floating-point-like fashion: exact below 2^(MANTISSA_BITS+1), then
+//   2^MANTISSA_BITS bins per octave. A coarse tier of bins, each summing VANILLA_SP_HISTOGRAM_COARSE_SIZE fine ones,
+//   keeps queries short.
+// - - - - - - - - - - - - - - - - - - - -
+
+#define VANILLA_SP_HISTOGRAM_BIN_COUNT       (VANILLA_SP_MAX_SYNAPSES_PER_SEG + 1u)
+#define VANILLA_SP_HISTOGRAM_MANTISSA_BITS   7u      // 256 exact bins, then 128 per octave => 2^21 max boosted level in 1920 bins
+#define VANILLA_SP_HISTOGRAM_COARSE_SHIFT    5u
+#define VANILLA_SP_HISTOGRAM_COARSE_SIZE     (1u << VANILLA_SP_HISTOGRAM_COARSE_SHIFT)
+#define VANILLA_SP_HISTOGRAM_COARSE_COUNT    ((VANILLA_SP_HISTOGRAM_BIN_COUNT + VANILLA_SP_HISTOGRAM_COARSE_SIZE - 1u) >> VANILLA_SP_HISTOGRAM_COARSE_SHIFT)
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType>
+FORCE_INLINE static u16fast _getHistogramBin(ActivationLevelType uActivationLevel) FORCE_INLINE_END {
+    uint32 uBin = uint32(uActivationLevel);
+    if (sizeof(ActivationLevelType) == 4u && uBin >> (VANILLA_SP_HISTOGRAM_MANTISSA_BITS + 1u)) { // boosted (static test)
+        uint32 uOctaveShift = getMostSignificantBitPos32(uBin) - VANILLA_SP_HISTOGRAM_MANTISSA_BITS;
+        uBin = (uOctaveShift << VANILLA_SP_HISTOGRAM_MANTISSA_BITS) + (uBin >> uOctaveShift);
+    }
+    return u16fast(std::min(uBin, uint32(VANILLA_SP_HISTOGRAM_BIN_COUNT - 1u)));
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Highest level falling in a bin
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType>
+FORCE_INLINE static uint32 _getHistogramBinTopLevel(u16fast uBin) FORCE_INLINE_END {
+    uint32 uTopLevel = uint32(uBin);
+    if (sizeof(ActivationLevelType) == 4u && uBin >> (VANILLA_SP_HISTOGRAM_MANTISSA_BITS + 1u)) { // boosted (static test)
+        uint32 uOctaveShift = (uTopLevel >> VANILLA_SP_HISTOGRAM_MANTISSA_BITS) - 1u;
+        uint32 uMantissa = uTopLevel - (uOctaveShift << VANILLA_SP_HISTOGRAM_MANTISSA_BITS);
+        uTopLevel = ((uMantissa + 1u) << uOctaveShift) - 1u;
+    }
+    return uTopLevel;
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Adds or removes (depending on bAdd) 'uCount' levels, 'uStride' apart, to the histogram
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType, bool bAdd>
+static void _updateLevelHistogram(const ActivationLevelType* pActivationLevels, u16fast uCount, u16fast uStride,
+    uint32 uLowestIn, uint16* pFineCounts, uint16* pCoarseCounts, u16fast& ioTotalCount)
+{
+    for (u16fast uRel = 0u; uRel < uCount; uRel++, pActivationLevels += uStride) {
+        ActivationLevelType uActivationLevel = *pActivationLevels;
+        if (uActivationLevel > uLowestIn) {
+            u16fast uBin = _getHistogramBin(uActivationLevel);
+            if (bAdd) { // static test
+                pFineCounts[uBin]++;
+                pCoarseCounts[uBin >> VANILLA_SP_HISTOGRAM_COARSE_SHIFT]++;
+                ioTotalCount++;
+            } else {
+                pFineCounts[uBin]--;
+                pCoarseCounts[uBin >> VANILLA_SP_HISTOGRAM_COARSE_SHIFT]--;
+                ioTotalCount--;
+            }
+        }
+    }
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Same as above for 'uCount' positions of a wrapped line of 'uLineSize' positions, 'uStride' apart, starting at 'uStart'
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType, bool bAdd>
+static void _updateLevelHistogramWrapped(const ActivationLevelType* pLineActivationLevels, u16fast uStart, u16fast uCount,
+    u16fast uLineSize, u16fast uStride, uint32 uLowestIn, uint16* pFineCounts, uint16* pCoarseCounts, u16fast& ioTotalCount)
+{
+    u16fast uCountToEnd = std::min(uCount, u16fast(uLineSize - uStart));
+    _updateLevelHistogram<ActivationLevelType, bAdd>(pLineActivationLevels + uStart * uStride, uCountToEnd, uStride,
+        uLowestIn, pFineCounts, pCoarseCounts, ioTotalCount);
+    _updateLevelHistogram<ActivationLevelType, bAdd>(pLineActivationLevels, uCount - uCountToEnd, uStride,
+        uLowestIn, pFineCounts, pCoarseCounts, ioTotalCount);
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Returns the level at or below which a column shall be inhibited, knowing current histogram and 'uWinnerK' ; this is
+//   the (K+1)-th best level from the histogram (up to bin quantisation), or the threshold value 'uLowestIn' if there are
+//   not that many levels above threshold. Also returns the count of best levels, as _getBestFromRange does.
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType>
+static uint32 _getBelowMinFromHistogram(const uint16* pFineCounts, const uint16* pCoarseCounts, u16fast uTotalCount,
+    u16fast uWinnerK, uint32 uLowestIn, u16fast* outCountBest)
+{
+    if (uTotalCount <= uWinnerK) {
+        *outCountBest = uTotalCount;
+        return uLowestIn;
+    }
+    *outCountBest = uWinnerK;
+    u16fast uCumulated = 0u;
+    u16fast uCoarse = VANILLA_SP_HISTOGRAM_COARSE_COUNT;
+    do {
+        uCoarse--;
+        uCumulated += pCoarseCounts[uCoarse];
+    } while (uCumulated <= uWinnerK);
+    uCumulated -= pCoarseCounts[uCoarse];
+    u16fast uBin = (uCoarse << VANILLA_SP_HISTOGRAM_COARSE_SHIFT) + VANILLA_SP_HISTOGRAM_COARSE_SIZE;
+    do {
+        uBin--;
+        uCumulated += pFineCounts[uBin];
+    } while (uCumulated <= uWinnerK);
+    return std::max(uLowestIn, _getHistogramBinTopLevel<ActivationLevelType>(uBin));
 }
 ; // template termination
 
+#endif // VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+
 // - - - - - - - - - - - - - - - - - - - -
 // Optimized one-best across neighborhood
 // - - - - - - - - - - - - - - - - - - - -
@@ -610,11 +1178,13 @@ fMax = fInput;
 }
 */
 
+#if defined(VANILLA_SP_USE_LOCAL_INHIB) && (VANILLA_SP_UPDATERAD_KIND != VANILLA_SP_UPDATERAD_KIND_CONST_NOUPDATE)
 // - - - - - - - - - - - - - - - - - - - -
 // Trying to behave as-was-intended
-// In particular, correctly handles wrapping concerns.
+// In particular, correctly handles wrapping concerns. 'pPermValues' holds the permanence of each synapse of 'segment'.
 // - - - - - - - - - - - - - - - - - - - -
-static float _computeCorrectedAvgConnectedSpanFor(u16fast uX, u16fast uY, u16fast uZCountInput, const VanillaSP::Segment& segment)
+static float _computeCorrectedAvgConnectedSpanFor(u16fast uX, u16fast uY, u16fast uZCountInput, const VanillaSP::Segment& segment,
+    const VANILLA_SP_SYN_PERM_TYPE* pPermValues)
 {
     if (uZCountInput > 1u) {
         // if input has more than one sheet, we're considered '3D'
@@ -623,7 +1193,7 @@ static float _computeCorrectedAvgConnectedSpanFor(u16fast uX, u16fast uY, u16fas
         u16fast uMaxDiffY = 0u;
         u16fast uCount = segment._uCount;
         const uint16* pPreSyn = segment._tPreSynIndex;
-        const VANILLA_SP_SYN_PERM_TYPE* pPerm = segment._tPermValue;
+        const VANILLA_SP_SYN_PERM_TYPE* pPerm = pPermValues;
         for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
             if (*pPerm >= VANILLA_SP_SYN_CONNECTED_PERM) {
                 u16fast uPreSynCellIndex = *pPreSyn;
@@ -645,7 +1215,7 @@ static float _computeCorrectedAvgConnectedSpanFor(u16fast uX, u16fast uY, u16fas
         u16fast uMaxDiffY = 0u;
         u16fast uCount = segment._uCount;
         const uint16* pPreSyn = segment._tPreSynIndex;
-        const VANILLA_SP_SYN_PERM_TYPE* pPerm = segment._tPermValue;
+        const VANILLA_SP_SYN_PERM_TYPE* pPerm = pPermValues;
         for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
             if (*pPerm >= VANILLA_SP_SYN_CONNECTED_PERM) {
                 u16fast uPreSynCellIndex = *pPreSyn;
@@ -663,6 +1233,7 @@ static float _computeCorrectedAvgConnectedSpanFor(u16fast uX, u16fast uY, u16fas
         return float(uTotalSpan);
     }
 }
+#endif
 
 #ifdef VANILLA_SP_USE_BOOSTING
 // - - - - - - - - - - - - - - - - - - - -
@@ -730,15 +1301,16 @@ FORCE_INLINE static uint16 _getBoostFactorUint16(float fTargetActiveRatio, float
 
 // - - - - - - - - - - - - - - - - - - - -
 // Fills the table of 'P'otential synapses (and their 'P'ermanence) for a given segment,
-//   while having a list of candidates at hand.
+//   while having a list of candidates at hand. Permanences are written to 'pPermValues', which is the table of the segment
+//   itself, unless they are bit-sliced.
 // - - - - - - - - - - - - - - - - - - - -
 static void _candidatesToPandP(uint16* pCandidates, u32fast uTotalCount, u16fast uConnectedCount,
-    Rand* pSynRand, VanillaSP::Segment& segment)
+    Rand* pSynRand, VanillaSP::Segment& segment, VANILLA_SP_SYN_PERM_TYPE* pPermValues)
 {
     u32fast uRemaining = uTotalCount;
     segment._uCount = 0u;
     uint16* pPreSyn = segment._tPreSynIndex;
-    VANILLA_SP_SYN_PERM_TYPE* pPerm = segment._tPermValue;
+    VANILLA_SP_SYN_PERM_TYPE* pPerm = pPermValues;
     // Continue drawing synapses from the candidates, until 'uConnectedCount' of them have been chosen.
     for(u32fast uAffected = 0u; uAffected < uConnectedCount; uAffected++, pPreSyn++, pPerm++) {
         // draw one candidate from the pool at random
@@ -765,7 +1337,8 @@ static void _candidatesToPandP(uint16* pCandidates, u32fast uTotalCount, u16fast
         int32 iPerm = int32(uBinaryConnectedDraw) * (int32(VANILLA_SP_SYN_CONNECTED_PERM) + iFixPt16bLerpedValIfConnected);
         iPerm += int32(1u-uBinaryConnectedDraw) * ((iLerpDraw * int32(VANILLA_SP_SYN_CONNECTED_PERM)) >> 8);
         *pPerm = uint16(iPerm);
-#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8)
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8) || \
+      (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
         int32 iLerpDraw = int32(uint8(pSynRand->getNext()));
         int32 iFixPt8bLerpedValIfConnected = ((255 - int32(VANILLA_SP_SYN_CONNECTED_PERM)) * iLerpDraw) >> 8;
         int32 iPerm = int32(uBinaryConnectedDraw) * (int32(VANILLA_SP_SYN_CONNECTED_PERM) + iFixPt8bLerpedValIfConnected);
@@ -784,13 +1357,13 @@ static void _candidatesToPandP(uint16* pCandidates, u32fast uTotalCount, u16fast
 //   when the potential connection area in fact covers the whole sheet
 // - - - - - - - - - - - - - - - - - - - -
 static void _initMapPotentialsGlobal(VanillaSP::Segment& segment, u16fast uX, u16fast uY, Rand* pSynRand,
-    u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer)
+    u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer, VANILLA_SP_SYN_PERM_TYPE* pPermValues)
 {
     uint16* pCurrent = pTmpBuffer;
     for (u32fast uCandidateIndex = 0u; uCandidateIndex < uTotalCount; uCandidateIndex++, pCurrent++) {
         *pCurrent = uint16(uCandidateIndex);
     }
-    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment);
+    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment, pPermValues);
 }
 
 // - - - - - - - - - - - - - - - - - - - -
@@ -798,7 +1371,8 @@ static void _initMapPotentialsGlobal(VanillaSP::Segment& segment, u16fast uX, u1
 //   when the potential connection area is beyond sheet height
 // - - - - - - - - - - - - - - - - - - - -
 static void _initMapPotentialsLocalAlongX(VanillaSP::Segment& segment, u16fast uX, u16fast uY, Rand* pSynRand,
-    u16fast uSizeX, u16fast uSizeZ, u16fast uPotentialRadius, u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer)
+    u16fast uSizeX, u16fast uSizeZ, u16fast uPotentialRadius, u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer,
+    VANILLA_SP_SYN_PERM_TYPE* pPermValues)
 {
     uint16* pCurrent = pTmpBuffer;
     u16fast uStartZIndex = 0u;
@@ -811,7 +1385,7 @@ static void _initMapPotentialsLocalAlongX(VanillaSP::Segment& segment, u16fast u
             }
         }
     }
-    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment);
+    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment, pPermValues);
 }
 
 // - - - - - - - - - - - - - - - - - - - -
@@ -819,7 +1393,8 @@ static void _initMapPotentialsLocalAlongX(VanillaSP::Segment& segment, u16fast u
 //   when the potential connection area is reasonnable (such as from default radius 12)
 // - - - - - - - - - - - - - - - - - - - -
 static void _initMapPotentialsFullyLocal(VanillaSP::Segment& segment, u16fast uX, u16fast uY, Rand* pSynRand,
-    u16fast uSizeXY, u16fast uSizeZ, u16fast uRadius, u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer)
+    u16fast uSizeXY, u16fast uSizeZ, u16fast uRadius, u32fast uTotalCount, u16fast uConnectedCount, uint16* pTmpBuffer,
+    VANILLA_SP_SYN_PERM_TYPE* pPermValues)
 {
     uint16* pCurrent = pTmpBuffer;
     u16fast uStartZIndex = 0u;
@@ -833,168 +1408,221 @@ static void _initMapPotentialsFullyLocal(VanillaSP::Segment& segment, u16fast uX
             }
         }
     }
-    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment);
+    _candidatesToPandP(pTmpBuffer, uTotalCount, uConnectedCount, pSynRand, segment, pPermValues);
 }
 
+// 32 taps of the gaussian kernel along one orientation, for relative offsets -16 up to +15 (summing to 4095). Note that the
+//   highest factor stands at offset -1, and none at offset 0: this is how the filter always did things, and has been kept
+//   as is since then, for results to stay the same.
+static const uint32 k_gaussianTaps[32u] = {
+    4u,   7u,   11u,  19u,  29u,  45u,  65u,  91u,
+    123u, 159u, 199u, 237u, 273u, 302u, 320u, 327u,
+    0u,   320u, 302u, 273u, 237u, 199u, 159u, 123u,
+    91u,  65u,  45u,  29u,  19u,  11u,  7u,   4u,
+};
+static const size_t k_uGaussianTapOrigin = 16u;
+
 // - - - - - - - - - - - - - - - - - - - -
-// Method used in case the VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI option is chosen:
-//   Required to compute the initial (after first init of potentials and permanences) connectivity field for a segment.
-//   After init, we won't use this same method, as we never brute-force or way through it: we'll rather update whenever a synapse
-//     changes from connected to unconnected status (or the other way around)
+// computes a gaussian filter over a 31x31 kernel, using the well known two-passes optimization (one for each dimension)
+//   The sheet being stored column after column, first pass is a wrapped-around convolution along each column (along y),
+//   second pass is a wrapped-around convolution across columns (along x) ; both using the kernels selected at construction
+//   time. 'pOutY' thus receives intermediate results in the same column-major layout as all others.
 // - - - - - - - - - - - - - - - - - - - -
-static void _initConnectivityField(const VanillaSP::Segment& segment, uint64* pConnectivityField, size_t uInputSheetsCount)
+template<typename ActivationLevelType, bool bOutputMinActivation>
+static void _computeGaussian(const ActivationLevelType* pActivationLevelsPerCol, uint32* pOutY, uint32* pOutFinal,
+    uint32* pOutputMinActivation, ConvolveLinesWrappedFunc pConvolveAlongFunc, ConvolveLinesWrappedFunc pConvolveAcrossFunc)
 {
-    memset((void*)pConnectivityField, 0, (VANILLA_HTM_SHEET_2DSIZE * uInputSheetsCount) >> 3u);
-    u16fast uCount = segment._uCount;
-    const uint16* pPreSyn = segment._tPreSynIndex;
-    const VANILLA_SP_SYN_PERM_TYPE* pPerm = segment._tPermValue;
-    for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
-        if (*pPerm >= VANILLA_SP_SYN_CONNECTED_PERM) {
-            u16fast uIndex = *pPreSyn;
-            u16fast uQword = uIndex >> 6u;
-            u16fast uBit = uIndex & 0x003Fu;
-            pConnectivityField[uQword] |= (1uLL << uBit);
-        }
-    }
-}
-
-// 15 factors along one orientation for '_getGaussianSum' implementation
-static const uint32 k_gaussianFactors[15u] = {
-    320u, 302u, 273u, 237u, 199u,
-    159u, 123u,  91u,  65u,  45u,
-    29u,  19u,  11u,   7u,   4u,
-};
-// 15 factors + center along one orientation for '_getGaussianSum' implementation
-static const uint32 k_revGaussianFactors[16u] = {
-    4u,   7u,   11u,  19u,  29u,  
-    45u,  65u,  91u,  123u, 159u, 
-    199u, 237u, 273u, 302u, 320u,
-    327u,
-};
-
-template<typename ActivationLevelType>
-FORCE_INLINE static uint32 _getGaussianSumRev(const ActivationLevelType* pActivationLevels,
-        u16fast uAlongMinor, u16fast uAlongMajor, u16fast uMajorSize) FORCE_INLINE_END {
-    uint32 uSum = 0u;
-    if (uAlongMajor < 16u) {
-        u16fast uOffsetsBefore = 16u - uAlongMajor;
-        const ActivationLevelType* pStart = pActivationLevels + (uAlongMinor * uMajorSize) + uMajorSize - uOffsetsBefore;
-        for (u16fast uOffset = 0u; uOffset < uOffsetsBefore; uOffset++) {
-            uSum += uint32(pStart[uOffset]) * k_revGaussianFactors[uOffset];
-        }
-        pStart = pActivationLevels + (uAlongMinor * uMajorSize);
-        for (u16fast uOffset = uOffsetsBefore; uOffset < 16u; uOffset++) {
-            uSum += uint32(pStart[uOffset - uOffsetsBefore]) * k_revGaussianFactors[uOffset];
+    // sum of gaussian factors is 4095 => shift by 12 nominally, or shift by 4 for first round of y
+    //   for when ActivationLevelType is 16b (=> "raw") so as to simulate boosted-by-1.0 (towards fixed pt 8b after point)
+    static const u8fast uShiftFirst = (sizeof(ActivationLevelType) == 2u) ? 4u : 12u;
+    uint32 tPaddedLine[VANILLA_HTM_SHEET_HEIGHT + 31u];
+    const uint32* pFirstPassInput;
+    if (sizeof(ActivationLevelType) == 2u) {
+        // kernels work on 32b values => widening to 'pOutFinal' first (not needed until second pass)
+        for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+            pOutFinal[uIndex] = uint32(pActivationLevelsPerCol[uIndex]);
         }
+        pFirstPassInput = pOutFinal;
     } else {
-        const ActivationLevelType* pStart = pActivationLevels + (uAlongMinor * uMajorSize) + uAlongMajor - 16u;
-        for (u16fast uOffset = 0u; uOffset < 16u; uOffset++) {
-            uSum += uint32(pStart[uOffset]) * k_revGaussianFactors[uOffset];
+        pFirstPassInput = reinterpret_cast<const uint32*>(pActivationLevelsPerCol);
+    }
+    pConvolveAlongFunc(pFirstPassInput, VANILLA_HTM_SHEET_HEIGHT, VANILLA_HTM_SHEET_WIDTH, k_gaussianTaps, 32u,
+        k_uGaussianTapOrigin, uShiftFirst, tPaddedLine, pOutY);
+    pConvolveAcrossFunc(pOutY, VANILLA_HTM_SHEET_HEIGHT, VANILLA_HTM_SHEET_WIDTH, k_gaussianTaps, 32u,
+        k_uGaussianTapOrigin, 12u, tPaddedLine, pOutFinal);
+    if (bOutputMinActivation) {
+        for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+            pOutputMinActivation[uIndex] += pOutFinal[uIndex];
         }
     }
-    return uSum;
 }
 ; // template termination
 
-template<typename ActivationLevelType>
-FORCE_INLINE static uint32 _getGaussianSumFwd(const ActivationLevelType* pActivationLevels,
-        u16fast uAlongMinor, u16fast uAlongMajor, u16fast uMajorSize) FORCE_INLINE_END {
-    uint32 uSum = 0u;
-    if (uAlongMajor + 16u > uMajorSize) {
-        u16fast uOffsetsBefore = uMajorSize - uAlongMajor - 1u;
-        const ActivationLevelType* pStart = pActivationLevels + (uAlongMinor * uMajorSize) + uAlongMajor + 1u;
-        for (u16fast uOffset = 0u; uOffset < uOffsetsBefore; uOffset++) {
-            uSum += uint32(pStart[uOffset]) * k_gaussianFactors[uOffset];
-        }
-        pStart = pActivationLevels + (uAlongMinor * uMajorSize);
-        for (u16fast uOffset = uOffsetsBefore; uOffset < 15u; uOffset++) {
-            uSum += uint32(pStart[uOffset - uOffsetsBefore]) * k_gaussianFactors[uOffset];
-        }
-    } else {
-        const ActivationLevelType* pStart = pActivationLevels + (uAlongMinor * uMajorSize) + uAlongMajor + 1u;
-        for (u16fast uOffset = 0u; uOffset < 15u; uOffset++) {
-            uSum += uint32(pStart[uOffset]) * k_gaussianFactors[uOffset];
+#if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+
+// - - - - - - - - - - - - - - - - - - - -
+// box filter of radius VANILLA_SP_BOXGAUSS_RADIUS across a set of 'uLineCount' lines (a power of two) of 'uLineLength'
+//   values each, wrapping around, as a running sum (running a whole line of sums at once)
+// - - - - - - - - - - - - - - - - - - - -
+template<typename SourceType>
+static void _boxFilterAcrossLines(const SourceType* pIn, u16fast uLineLength, u16fast uLineCount, uint32* pOut)
+{
+    static const u16fast uRadius = VANILLA_SP_BOXGAUSS_RADIUS;
+    u16fast uLineMask = uLineCount - 1u;
+    uint32 tSums[VANILLA_HTM_SHEET_WIDTH];     // max of both sheet sizes
+    std::memset((void*)tSums, 0, sizeof(uint32)*uLineLength);
+    for (u16fast uRelLine = 0u; uRelLine <= 2u*uRadius; uRelLine++) {
+        const SourceType* pLine = pIn + ((uRelLine - uRadius) & uLineMask) * uLineLength;
+        for (u16fast uPos = 0u; uPos < uLineLength; uPos++) {
+            tSums[uPos] += uint32(pLine[uPos]);
+        }
+    }
+    for (u16fast uLine = 0u; uLine < uLineCount; uLine++, pOut += uLineLength) {
+        const SourceType* pEntering = pIn + ((uLine + uRadius + 1u) & uLineMask) * uLineLength;
+        const SourceType* pLeaving = pIn + ((uLine - uRadius) & uLineMask) * uLineLength;
+        for (u16fast uPos = 0u; uPos < uLineLength; uPos++) {
+            pOut[uPos] = tSums[uPos];
+            tSums[uPos] += uint32(pEntering[uPos]) - uint32(pLeaving[uPos]);
         }
     }
-    return uSum;
 }
 ; // template termination
 
 // - - - - - - - - - - - - - - - - - - - -
-// computes a gaussian filter over a 31x31 kernel, using the well known two-passes optimization (one for each dimension)
+// approximates the gaussian filter of '_computeGaussian' by a cascade of three box filters along each dimension, of same
+//   overall variance. Each output costs a constant number of additions, whatever the radius. Results are normalized to the
+//   same scale as '_computeGaussian' ones (8b after point for raw levels).
+//   Box filters are only ever run across lines, where each step is a plain addition of whole lines: along x first, on the
+//   column-major sheet, then along y after transposing to row-major, and back.
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ActivationLevelType, bool bOutputMinActivation>
-static void _computeGaussian(const ActivationLevelType* pActivationLevelsPerCol, uint32* pOutY, uint32* pOutFinal,
+static void _computeBoxGaussian(const ActivationLevelType* pActivationLevelsPerCol, uint32* pOutY, uint32* pOutFinal,
     uint32* pOutputMinActivation)
 {
-    // sum of gaussian factors is 4095 => shift by 12 nominally, or shift by 4 for first round of y
-    //   for when ActivationLevelType is 16b (=> "raw") so as to simulate boosted-by-1.0 (towards fixed pt 8b after point)
+    // same shifts as _computeGaussian, whose factors sum to 4095 (=> 12b) ; our own cascade mass is corrected by an
+    //   11b-after-point factor which brings it to that same 4095.
     static const u16fast uShiftFirst = (sizeof(ActivationLevelType) == 2u) ? 4u : 12u;
+    static const uint64 uBoxWidth = 2uLL * uint64(VANILLA_SP_BOXGAUSS_RADIUS) + 1uLL;
+    static const uint64 uCascadeMass = uBoxWidth * uBoxWidth * uBoxWidth;
+    static const uint64 uNormalizingFactor = ((4095uLL << 11u) + (uCascadeMass >> 1u)) / uCascadeMass;
+    _boxFilterAcrossLines<ActivationLevelType>(pActivationLevelsPerCol, VANILLA_HTM_SHEET_HEIGHT, VANILLA_HTM_SHEET_WIDTH,
+        pOutY);
+    _boxFilterAcrossLines<uint32>(pOutY, VANILLA_HTM_SHEET_HEIGHT, VANILLA_HTM_SHEET_WIDTH, pOutFinal);
+    _boxFilterAcrossLines<uint32>(pOutFinal, VANILLA_HTM_SHEET_HEIGHT, VANILLA_HTM_SHEET_WIDTH, pOutY);
+    const uint32* pCurrentIn = pOutY;
     for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-        uint32* pCurrentOut = pOutY + uX;
-        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
-            uint32 uCurrentSum = 0u;
-            uCurrentSum += _getGaussianSumRev<ActivationLevelType>(pActivationLevelsPerCol, uX, uY, VANILLA_HTM_SHEET_HEIGHT);
-            uCurrentSum += _getGaussianSumFwd<ActivationLevelType>(pActivationLevelsPerCol, uX, uY, VANILLA_HTM_SHEET_HEIGHT);
-            uint32 uValue = uCurrentSum >> uShiftFirst;
-            *pCurrentOut = uValue;
-            pCurrentOut += VANILLA_HTM_SHEET_WIDTH;
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentIn++) {
+            pOutFinal[uY * VANILLA_HTM_SHEET_WIDTH + uX] =
+                uint32((uint64(*pCurrentIn) * uNormalizingFactor) >> (11u + uShiftFirst));
         }
     }
+    _boxFilterAcrossLines<uint32>(pOutFinal, VANILLA_HTM_SHEET_WIDTH, VANILLA_HTM_SHEET_HEIGHT, pOutY);
+    _boxFilterAcrossLines<uint32>(pOutY, VANILLA_HTM_SHEET_WIDTH, VANILLA_HTM_SHEET_HEIGHT, pOutFinal);
+    _boxFilterAcrossLines<uint32>(pOutFinal, VANILLA_HTM_SHEET_WIDTH, VANILLA_HTM_SHEET_HEIGHT, pOutY);
+    uint32* pCurrentOut = pOutFinal;
     uint32* pCurrentMin = pOutputMinActivation;
-    for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
-        uint32* pCurrentOut = pOutFinal + uY;
-        uint32* pCurrentMin = pOutputMinActivation;
-        if (bOutputMinActivation)
-            pCurrentMin += uY;
-        for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-            uint32 uCurrentSum = 0u;
-            uCurrentSum += _getGaussianSumRev<uint32>(pOutY, uY, uX, VANILLA_HTM_SHEET_WIDTH);
-            uCurrentSum += _getGaussianSumFwd<uint32>(pOutY, uY, uX, VANILLA_HTM_SHEET_WIDTH);
-            uint32 uValue = uCurrentSum >> 12u;
+    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentOut++) {
+            uint32 uValue = uint32((uint64(pOutY[uY * VANILLA_HTM_SHEET_WIDTH + uX]) * uNormalizingFactor) >> 23u);
             *pCurrentOut = uValue;
-            pCurrentOut += VANILLA_HTM_SHEET_HEIGHT;
             if (bOutputMinActivation) {
                 *pCurrentMin += uValue;
-                pCurrentMin += VANILLA_HTM_SHEET_HEIGHT;
+                pCurrentMin++;
             }
         }
     }
+}
+; // template termination
 
-    /*
-    const ActivationLevelType* pCurrentActivation = pActivationLevelsPerCol;
-    uint32* pCurrentOut = pOutY;
-    // sum of gaussian factors is 4095 => shift by 12 nominally, or shift by 4 for first round of y
-    //   for when ActivationLevelType is 16b (=> "raw") so as to simulate boosted-by-1.0 (towards fixed pt 8b after point)
-    static const u16fast uShiftFirst = (sizeof(ActivationLevelType) == 2u) ? 4u : 12u;
+#endif // VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER
+
+#if defined(VANILLA_SP_ADD_ONE_7x7)
+
+// - - - - - - - - - - - - - - - - - - - -
+// max filter 7-wide along each column (along y), wrapping around. Each column is first padded with 3 values on each side,
+//   then maxes are taken over 2, 4, then 7 values (as two overlapping 4-wide ranges) => 3 max ops per output only.
+// - - - - - - - - - - - - - - - - - - - -
+static void _maxFilter7AlongY(const uint32* pIn, uint32* pOut)
+{
+    uint32 tPadded[VANILLA_HTM_SHEET_HEIGHT + 6u];
+    uint32 tMax2[VANILLA_HTM_SHEET_HEIGHT + 5u];
+    uint32 tMax4[VANILLA_HTM_SHEET_HEIGHT + 3u];
+    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++, pIn += VANILLA_HTM_SHEET_HEIGHT, pOut += VANILLA_HTM_SHEET_HEIGHT) {
+        for (u16fast uPos = 0u; uPos < VANILLA_HTM_SHEET_HEIGHT + 6u; uPos++) {
+            tPadded[uPos] = pIn[(uPos - 3u) & VANILLA_HTM_SHEET_YMASK];
+        }
+        for (u16fast uPos = 0u; uPos < VANILLA_HTM_SHEET_HEIGHT + 5u; uPos++) {
+            tMax2[uPos] = std::max(tPadded[uPos], tPadded[uPos + 1u]);
+        }
+        for (u16fast uPos = 0u; uPos < VANILLA_HTM_SHEET_HEIGHT + 3u; uPos++) {
+            tMax4[uPos] = std::max(tMax2[uPos], tMax2[uPos + 2u]);
+        }
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+            pOut[uY] = std::max(tMax4[uY], tMax4[uY + 3u]);
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// max filter 7-wide across columns (along x), wrapping around. Same 2, 4, then 7 scheme as above, but on whole columns at
+//   once. 'pInAndTmp' is used as a temporary buffer (and thus overwritten), 'pTmp' as well ('pOut' may be 'pTmp').
+// - - - - - - - - - - - - - - - - - - - -
+static void _maxFilter7AlongX(uint32* pInAndTmp, uint32* pTmp, uint32* pOut)
+{
+    // max over 2 columns, from x to x+1, to 'pTmp'
     for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentActivation++, pCurrentOut++) {
-            uint32 uCurrentSum = uint32(*pCurrentActivation) * k_uFactorForCenter;
-            uCurrentSum += _getGaussianSumYrev<ActivationLevelType>(pActivationLevelsPerCol, uX, uY);
-            uCurrentSum += _getGaussianSumY<ActivationLevelType>(pActivationLevelsPerCol, uX, uY);
-            uint32 uValue = uCurrentSum >> uShiftFirst;
-            *pCurrentOut = uValue;
+        const uint32* pColumn = pInAndTmp + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        const uint32* pNextColumn = pInAndTmp + (((uX + 1u) & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        uint32* pCurrentOut = pTmp + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+            pCurrentOut[uY] = std::max(pColumn[uY], pNextColumn[uY]);
         }
     }
-    const uint32* pCurrentY = pOutY;
-    uint32* pCurrentMin = pOutputMinActivation;
-    pCurrentOut = pOutFinal;
+    // max over 4 columns, from x to x+3, back to 'pInAndTmp'
     for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentY++, pCurrentOut++) {
-            uint32 uCurrentSum = (*pCurrentY) * k_uFactorForCenter;
-            uCurrentSum += _getGaussianSumXrev<uint32>(pOutY, uX, uY);
-            uCurrentSum += _getGaussianSumX<uint32>(pOutY, uX, uY);
-            uint32 uValue = uCurrentSum >> 12u;
-            *pCurrentOut = uValue;
-            if (bOutputMinActivation) {
-                *pCurrentMin += uValue;
-                pCurrentMin++;
-            }
+        const uint32* pColumn = pTmp + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        const uint32* pNextColumn = pTmp + (((uX + 2u) & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        uint32* pCurrentOut = pInAndTmp + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+            pCurrentOut[uY] = std::max(pColumn[uY], pNextColumn[uY]);
+        }
+    }
+    // max over 7 columns, from x-3 to x+3
+    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
+        const uint32* pColumn = pInAndTmp + (((uX - 3u) & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        const uint32* pNextColumn = pInAndTmp + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        uint32* pCurrentOut = pOut + (uX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+            pCurrentOut[uY] = std::max(pColumn[uY], pNextColumn[uY]);
         }
     }
-    */
 }
-; // template termination
+
+#endif // VANILLA_SP_ADD_ONE_7x7
+
+#if defined(VANILLA_SP_ADD_INVSQDIST_REPULSE)
+
+// Half-height h, along y, of the area forbidden around a winner for each x offset from -6 to +6 when enforcing a min
+//   euclidean distance of 6.5 (=> squared distance 42 at most is forbidden): dy from -h to +h
+static const uint32 k_repulseHalfHeightPerDx[13u] = {
+    2u, 4u, 5u, 5u, 6u, 6u, 6u, 6u, 6u, 5u, 5u, 4u, 2u,
+};
+
+// - - - - - - - - - - - - - - - - - - - -
+// marks the area around column ('uX', 'uY') where no other winner may stand, in a per-x occupancy bitfield (one 32b
+//   word per x, one bit per y), wrapping around
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE static void _markRepulseArea(uint32* pOccupiedPerX, u16fast uX, u16fast uY) FORCE_INLINE_END {
+    for (u16fast uRelX = 0u; uRelX < 13u; uRelX++) {
+        u16fast uHalfHeight = k_repulseHalfHeightPerDx[uRelX];
+        uint32 uMask = (1u << (2u * uHalfHeight + 1u)) - 1u;
+        u16fast uShift = (uY - uHalfHeight) & VANILLA_HTM_SHEET_YMASK;
+        uint32 uRotatedMask = (uMask << uShift) | (uMask >> ((32u - uShift) & 31u));
+        pOccupiedPerX[(uX + uRelX - 6u) & VANILLA_HTM_SHEET_XMASK] |= uRotatedMask;
+    }
+}
+
+#endif // VANILLA_SP_ADD_INVSQDIST_REPULSE
 
 // - - - - - - - - - - - - - - - - - - - -
 // reduces a table of activation levels, given a table of reduction values. clamp results to zero before assigning to 'pResult'
@@ -1069,6 +1697,43 @@ static u16fast _reduceByAmountPointwiseInvScaled(const ActivationLevelType* pAct
 ; // template termination
 
 
+// - - - - - - - - - - - - - - - - - - - -
+// Builds the compacted list of non-zero qwords from a bitfield: their offsets in 'pOutOffsets', and their values in
+//   'pOutValues'. Returns the count of such qwords, and also outputs the total count of set bits found in 'pOutSetBitsCount'
+// - - - - - - - - - - - - - - - - - - - -
+static size_t _compactNonZeroQwords(const uint64* pBinaryBitmap, size_t uQwordCount, uint32* pOutOffsets,
+    uint64* pOutValues, uint64* pOutSetBitsCount)
+{
+    size_t uNonZeroCount = 0u;
+    uint64 uSetBitsCount = 0uLL;
+    for (size_t uQword = 0u; uQword < uQwordCount; uQword++) {
+        uint64 uValue = pBinaryBitmap[uQword];
+        // unbranching: always writing at current end of list, however only advancing it if non-zero
+        pOutOffsets[uNonZeroCount] = uint32(uQword);
+        pOutValues[uNonZeroCount] = uValue;
+        uNonZeroCount += size_t(0uLL != uValue);
+        uSetBitsCount += countSetBits64(uValue);
+    }
+    *pOutSetBitsCount = uSetBitsCount;
+    return uNonZeroCount;
+}
+
+#ifdef VANILLA_SP_USE_BOOSTING
+// - - - - - - - - - - - - - - - - - - - -
+// Multiplies 'uColumnCount' activation levels by their respective (8b after point) boost factors
+// - - - - - - - - - - - - - - - - - - - -
+static void _applyBoostFactors(const uint16* pActivationLevelsPerCol, const uint16* pBoostingPerCol, size_t uColumnCount,
+    uint32* pOutputBoostedActivationLevelsPerCol)
+{
+    uint32* pCurrentColOutput = pOutputBoostedActivationLevelsPerCol;
+    const uint16* pCurrentColBoosting = pBoostingPerCol;
+    for (const uint16 *pCurrentColInput = pActivationLevelsPerCol, *pEndInput = pActivationLevelsPerCol + uColumnCount;
+        pCurrentColInput < pEndInput; pCurrentColInput++, pCurrentColBoosting++, pCurrentColOutput++) {
+        *pCurrentColOutput = uint32(*pCurrentColInput) * uint32(*pCurrentColBoosting);
+    }
+}
+#endif
+
 #ifdef VANILLA_SP_DEBUG
 // - - - - - - - - - - - - - - - - - - - -
 // Debug helper method
@@ -1087,17 +1752,299 @@ static void _debugConnectivityField(const uint64* pConnectivityField, size_t uCo
 }
 #endif
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE size_t VanillaSPInferenceCore::_getConnectivityWindowStartQword(u16fast uX) const FORCE_INLINE_END
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    if (_uConnectivityFieldsQwordSizePerSheet < uQwordsPerBinarySheet) {
+        // two x-coords per qword => window starts at the qword holding (x - radius)
+        return size_t(u16fast(uX - _uPotentialConnectivityRadius) & VANILLA_HTM_SHEET_XMASK) >> 1u;
+    }
+    return 0u;
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE size_t VanillaSP::_getConnectivityFieldQwordPos(u16fast uColumnIndex,
+    u32fast uPreSynCellIndex) const FORCE_INLINE_END
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    size_t uSheet = size_t(uPreSynCellIndex) >> VANILLA_HTM_SHEET_SHIFT_DIV2D;
+    size_t uQwordInSheet = (size_t(uPreSynCellIndex) & VANILLA_HTM_SHEET_2DMASK) >> 6u;
+    size_t uPosInWindow = (uQwordInSheet - _getConnectivityWindowStartQword(uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY)) &
+        (uQwordsPerBinarySheet - 1u);
+    if (uPosInWindow < _uConnectivityFieldsQwordSizePerSheet)
+        return uSheet * _uConnectivityFieldsQwordSizePerSheet + uPosInWindow;
+    else
+        return _uConnectivityFieldsQwordSizePerColumn;
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE u32fast VanillaSP::_getPreSynCellIndexFromFieldPos(u16fast uColumnIndex, size_t uFieldQwordPos,
+    u16fast uBit) const FORCE_INLINE_END
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    size_t uSheet = uFieldQwordPos / _uConnectivityFieldsQwordSizePerSheet;
+    size_t uPosInWindow = uFieldQwordPos - uSheet * _uConnectivityFieldsQwordSizePerSheet;
+    size_t uQwordInSheet = (_getConnectivityWindowStartQword(uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY) + uPosInWindow) &
+        (uQwordsPerBinarySheet - 1u);
+    return u32fast((uSheet << VANILLA_HTM_SHEET_SHIFT_DIV2D) | (uQwordInSheet << 6u) | size_t(uBit));
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Required to compute the initial (after first init of potentials and permanences) connectivity field for a segment.
+//   After init, we won't use this same method, as we never brute-force or way through it: we'll rather update whenever a synapse
+//     changes from connected to unconnected status (or the other way around)
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_initConnectivityField(u16fast uColumnIndex)
+{
+    uint64* pConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uColumnIndex;
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    // connected synapses are the ones at or above threshold in the bitplanes, 64 of them at a time
+    const uint64* pPlanes = _pPermanencePlanes + _uConnectivityFieldsQwordSizePerColumn * (size_t(uColumnIndex) << 3u);
+    for (size_t uQword = 0u; uQword < _uConnectivityFieldsQwordSizePerColumn; uQword++) {
+        pConnectivityField[uQword] = getBitSlicedAtOrAbove(pPlanes + uQword, _uConnectivityFieldsQwordSizePerColumn,
+            VANILLA_SP_SYN_CONNECTED_PERM);
+    }
+#else
+    memset((void*)pConnectivityField, 0, _uConnectivityFieldsQwordSizePerColumn * sizeof(uint64));
+    const Segment& segment = _pSegments[uColumnIndex];
+    u16fast uCount = segment._uCount;
+    const uint16* pPreSyn = segment._tPreSynIndex;
+    const VANILLA_SP_SYN_PERM_TYPE* pPerm = segment._tPermValue;
+    for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
+        if (*pPerm >= VANILLA_SP_SYN_CONNECTED_PERM) {
+            u16fast uIndex = *pPreSyn;
+            size_t uQword = _getConnectivityFieldQwordPos(uColumnIndex, uIndex);
+            u16fast uBit = uIndex & 0x003Fu;
+            pConnectivityField[uQword] |= (1uLL << uBit);
+        }
+    }
+#endif
+}
+
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_initPermanencePlanes(u16fast uColumnIndex, const VANILLA_SP_SYN_PERM_TYPE* pPermValues)
+{
+    size_t uFieldSize = _uConnectivityFieldsQwordSizePerColumn;
+    memset((void*)(_pPotentialFields + uFieldSize * uColumnIndex), 0, uFieldSize * sizeof(uint64));
+    memset((void*)(_pPermanencePlanes + uFieldSize * (size_t(uColumnIndex) << 3u)), 0, 8u * uFieldSize * sizeof(uint64));
+    const Segment& segment = _pSegments[uColumnIndex];
+    u16fast uCount = segment._uCount;
+    const uint16* pPreSyn = segment._tPreSynIndex;
+    for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPermValues++) {
+        _setPermanenceInPlanes(uColumnIndex, *pPreSyn, *pPermValues);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+VANILLA_SP_SYN_PERM_TYPE VanillaSP::_getPermanenceFromPlanes(u16fast uColumnIndex, u32fast uPreSynCellIndex) const
+{
+    size_t uFieldSize = _uConnectivityFieldsQwordSizePerColumn;
+    size_t uQword = _getConnectivityFieldQwordPos(uColumnIndex, uPreSynCellIndex);
+    if (uQword >= uFieldSize)
+        return 0u;
+    const uint64* pPlanes = _pPermanencePlanes + uFieldSize * (size_t(uColumnIndex) << 3u) + uQword;
+    u16fast uBit = uPreSynCellIndex & 0x003Fu;
+    u32fast uPermanence = 0u;
+    for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+        uPermanence |= u32fast((pPlanes[uPlane * uFieldSize] >> uBit) & 1uLL) << uPlane;
+    }
+    return VANILLA_SP_SYN_PERM_TYPE(uPermanence);
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_setPermanenceInPlanes(u16fast uColumnIndex, u32fast uPreSynCellIndex, VANILLA_SP_SYN_PERM_TYPE permanence)
+{
+    size_t uFieldSize = _uConnectivityFieldsQwordSizePerColumn;
+    size_t uQword = _getConnectivityFieldQwordPos(uColumnIndex, uPreSynCellIndex);
+    if (uQword >= uFieldSize)
+        return;
+    uint64 uMask = 1uLL << (uPreSynCellIndex & 0x003Fu);
+    _pPotentialFields[uFieldSize * uColumnIndex + uQword] |= uMask;
+    uint64* pPlanes = _pPermanencePlanes + uFieldSize * (size_t(uColumnIndex) << 3u) + uQword;
+    for (u8fast uPlane = 0u; uPlane < 8u; uPlane++) {
+        uint64 uPlaneBit = 0uLL - uint64((permanence >> uPlane) & 1u);
+        pPlanes[uPlane * uFieldSize] = (pPlanes[uPlane * uFieldSize] & ~uMask) | (uPlaneBit & uMask);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_gatherPermanencesFromPlanes(u16fast uColumnIndex, VANILLA_SP_SYN_PERM_TYPE* pOutPermValues) const
+{
+    const Segment& segment = _pSegments[uColumnIndex];
+    u16fast uCount = segment._uCount;
+    const uint16* pPreSyn = segment._tPreSynIndex;
+    for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pOutPermValues++) {
+        *pOutPermValues = _getPermanenceFromPlanes(uColumnIndex, *pPreSyn);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_updatePermanencePlanes(const uint64* pInputBinaryBitmap, u16fast uColumnIndex, uint8 uIncrease,
+    uint8 uDecrease, uint32** ppDeferredIndexUpdates)
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    size_t uFieldSize = _uConnectivityFieldsQwordSizePerColumn;
+    uint64* pConnectivityField = _pConnectivityFields + uFieldSize * uColumnIndex;
+    const uint64* pPotentialField = _pPotentialFields + uFieldSize * uColumnIndex;
+    size_t uWindowStartQword = _getConnectivityWindowStartQword(uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY);
+
+    // windowing the input onto the field layout, as masks of the potential synapses to increase or decrease
+    uint64 tIncreaseMasks[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+    uint64 tDecreaseMasks[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+    uint64 tConnected[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+    size_t uQword = 0u;
+    for (size_t uSheetStart = 0u; uSheetStart < _uInputQwordCount; uSheetStart += uQwordsPerBinarySheet) {
+        for (size_t uPos = 0u; uPos < _uConnectivityFieldsQwordSizePerSheet; uPos++, uQword++) {
+            size_t uInputQword = uSheetStart + ((uWindowStartQword + uPos) & (uQwordsPerBinarySheet - 1u));
+            uint64 uInput = pInputBinaryBitmap ? pInputBinaryBitmap[uInputQword] : ~0uLL;
+            tIncreaseMasks[uQword] = pPotentialField[uQword] & uInput;
+            tDecreaseMasks[uQword] = pPotentialField[uQword] & ~uInput;
+        }
+    }
+
+    _pUpdatePermanencesFunc(_pPermanencePlanes + uFieldSize * (size_t(uColumnIndex) << 3u), uFieldSize, tIncreaseMasks,
+        tDecreaseMasks, uIncrease, uDecrease, VANILLA_SP_SYN_CONNECTED_PERM, tConnected);
+
+    // synapses which crossed the connection threshold (either way) are those now differing from the field
+    uQword = 0u;
+    for (size_t uSheetStart = 0u; uSheetStart < _uInputQwordCount; uSheetStart += uQwordsPerBinarySheet) {
+        for (size_t uPos = 0u; uPos < _uConnectivityFieldsQwordSizePerSheet; uPos++, uQword++) {
+            uint64 uConnected = tConnected[uQword];
+            uint64 uCrossings = uConnected ^ pConnectivityField[uQword];
+            if (0uLL == uCrossings)
+                continue;
+            size_t uInputQword = uSheetStart + ((uWindowStartQword + uPos) & (uQwordsPerBinarySheet - 1u));
+            while (uCrossings) {
+                u16fast uBit = u16fast(getTrailingZeroesCount64(uCrossings));
+                uCrossings &= uCrossings - 1uLL;
+                u16fast uPreSynCellIndex = u16fast((uInputQword << 6u) | uBit);
+                if ((uConnected >> uBit) & 1uLL) {
+                    _connectSynapseInField(pConnectivityField, uColumnIndex, uPreSynCellIndex, ppDeferredIndexUpdates);
+                } else {
+                    _disconnectSynapseInField(pConnectivityField, uColumnIndex, uPreSynCellIndex, ppDeferredIndexUpdates);
+                }
+            }
+        }
+    }
+}
+
+#endif // VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// VanillaSPScratch ctor
+// - - - - - - - - - - - - - - - - - - - -
+VanillaSPScratch::VanillaSPScratch(size_t uInputQwordCount)
+{
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    _pTmpActiveInputQwordOffsets = new uint32[uInputQwordCount];
+    _pTmpActiveInputQwordValues = new uint64[uInputQwordCount];
+#else
+    HTMATCH_unused(uInputQwordCount);
+#endif
+    _pTmpTableBest = new uint32[VANILLA_SP_MAX_WINNERS + 1u];    // sized for any K => no reallocation when K changes
+    _pTmpRadixSelectCounts = new uint16[1u << VANILLA_SP_RADIX_SELECT_DIGIT_BITS];
+    _pTmpRadixSelectCandidates = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+#    ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+    _pTmpHistogramFineCounts = new uint16[VANILLA_SP_HISTOGRAM_COARSE_COUNT << VANILLA_SP_HISTOGRAM_COARSE_SHIFT];
+    _pTmpHistogramCoarseCounts = new uint16[VANILLA_SP_HISTOGRAM_COARSE_COUNT];
+    _pTmpBelowMinPerCol = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+#    endif
+#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+        (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    _pTmpGaussY = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+    _pTmpGaussX = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+    _pReducedActivations = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+#    elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
+    _pTmpKBestLists = 0;                    // allocated on first use, for the K of the SP it then serves
+    _uKBestListsTableSize = 0u;
+#    endif
+#  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
+    _pTmpBucketWinners = new uint16[VANILLA_HTM_SHEET_2DSIZE];             // buckets tile the sheet => enough for any size
+    _pTmpBucketWinnerCounts = new uint16[VANILLA_HTM_SHEET_2DSIZE >> 4u];  // sized for smallest buckets, 4x4
+#  endif
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// VanillaSPScratch dtor
+// - - - - - - - - - - - - - - - - - - - -
+VanillaSPScratch::~VanillaSPScratch()
+{
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    delete[] _pTmpActiveInputQwordOffsets;
+    delete[] _pTmpActiveInputQwordValues;
+#endif
+    delete[] _pTmpTableBest;
+    delete[] _pTmpRadixSelectCounts;
+    delete[] _pTmpRadixSelectCandidates;
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+#    ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+    delete[] _pTmpHistogramFineCounts;
+    delete[] _pTmpHistogramCoarseCounts;
+    delete[] _pTmpBelowMinPerCol;
+#    endif
+#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+        (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    delete[] _pTmpGaussY;
+    delete[] _pTmpGaussX;
+    delete[] _pReducedActivations;
+#    elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
+    delete[] _pTmpKBestLists;
+#    endif
+#  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
+    delete[] _pTmpBucketWinners;
+    delete[] _pTmpBucketWinnerCounts;
+#  endif
+#endif
+}
+
+#if defined(VANILLA_SP_USE_LOCAL_INHIB) && (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL) && \
+    (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
+// - - - - - - - - - - - - - - - - - - - -
+// Ensures the k-best lists can hold 'uTableSize' (K+1) values per column. K follows density and inhibition radius, and
+//   seldom reaches VANILLA_SP_MAX_WINNERS => sized for the current K only, growing when it increases
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSPScratch::_reserveKBestLists(size_t uTableSize)
+{
+    if (uTableSize > _uKBestListsTableSize) {
+        delete[] _pTmpKBestLists;
+        _uKBestListsTableSize = uTableSize;
+        _pTmpKBestLists = new uint32[size_t(VANILLA_HTM_SHEET_2DSIZE) * _uKBestListsTableSize * 4u];
+    }
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - -
 // VanillaSP ctor
 // - - - - - - - - - - - - - - - - - - - -
 VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRadius, float fPotentialConnectivityRatio,
                      float fActivationDensityRatio, float fOverThresholdTargetVsMaxRatio, uint64 uColumnUsageIntegrationWindow,
                      uint64 uSeed)
+    : _scratch(size_t(uNumberOfInputSheets) * (VANILLA_HTM_SHEET_2DSIZE >> 6u))
 {
     static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
     _pTmpBinaryInputBuffer = new uint64[size_t(uNumberOfInputSheets) * uQwordsPerBinarySheet];
     _pTmpBinaryOutputBuffer = new uint64[uQwordsPerBinarySheet];
     _pTmpBinaryOverThresholdActivations = new uint64[uQwordsPerBinarySheet];
+    _vecTmpOutputIndices.reserve(VANILLA_HTM_SHEET_2DSIZE);    // can't ever need more => no reallocation past this point
 
     _uInputSheetsCount = uNumberOfInputSheets;
     _uPotentialConnectivityRadius = uPotentialConnectivityRadius;
@@ -1106,6 +2053,7 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
     _fActivationDensityRatio = fActivationDensityRatio;
     _fOverThresholdTargetVsMaxRatio = fOverThresholdTargetVsMaxRatio;
     _uColumnUsageIntegrationWindow = uColumnUsageIntegrationWindow;
+    _bUnderUsedColumnsBurstMode = false;
 
     _uEpoch = 0u;
     _uEpochLearning = 0u;
@@ -1113,11 +2061,24 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
     _pAverageOverThresholdRatioPerColumn = new float[VANILLA_HTM_SHEET_2DSIZE];
     _pOverThresholdRatioTargetPerColumn = new float[VANILLA_HTM_SHEET_2DSIZE];
     _pInactiveEpochsPerColumn = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    _pOverThresholdRatioEpochPerColumn = new uint64[VANILLA_HTM_SHEET_2DSIZE];
+    _pActiveRatioEpochPerColumn = new uint64[VANILLA_HTM_SHEET_2DSIZE];
+#endif
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+    _pTmpMaxFilterValues = new float[VANILLA_HTM_SHEET_2DSIZE * 4u];
+#  endif
+#endif
     for (size_t uCol = 0; uCol < size_t(VANILLA_HTM_SHEET_2DSIZE); uCol++) {
         _pAverageActiveRatioPerColumn[uCol] = fActivationDensityRatio;
         _pAverageOverThresholdRatioPerColumn[uCol] = VANILLA_SP_OVERTHRESHOLD_INIT;
         _pOverThresholdRatioTargetPerColumn[uCol] = VANILLA_SP_OVERTHRESHOLD_INIT * VANILLA_SP_DEFAULT_TARGET_VS_MAX_RATIO;
         _pInactiveEpochsPerColumn[uCol] = 0u;
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+        _pOverThresholdRatioEpochPerColumn[uCol] = 0u;
+        _pActiveRatioEpochPerColumn[uCol] = 0u;
+#endif
     }
     _pTmpRawActivationLevelsPerCol = new uint16[VANILLA_HTM_SHEET_2DSIZE];
 #ifdef VANILLA_SP_USE_BOOSTING
@@ -1129,6 +2090,26 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
     }
 #endif
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    _uInputQwordCount = size_t(uNumberOfInputSheets) * uQwordsPerBinarySheet;
+    _uConnectivityFieldsQwordSizePerSheet = uQwordsPerBinarySheet;
+#  ifdef VANILLA_SP_USE_WINDOWED_CONNECTIVITY_FIELDS
+    if (uPotentialConnectivitySideSize >= VANILLA_SP_MIN_AREA_SIDE_SIZE &&
+        uPotentialConnectivitySideSize < VANILLA_HTM_SHEET_WIDTH) {
+        // potential x-range spans 1+2*radius x-coords, from (x - radius). Since each qword holds two x-coords, with
+        //   (x - radius) and (x + radius) having same parity, this always touches exactly radius+1 qwords per sheet
+        _uConnectivityFieldsQwordSizePerSheet = std::min(uQwordsPerBinarySheet, size_t(uPotentialConnectivityRadius) + 1u);
+    }
+#  endif
+    _uConnectivityFieldsQwordSizePerColumn = size_t(uNumberOfInputSheets) * _uConnectivityFieldsQwordSizePerSheet;
+#  if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    // (bit-sliced permanences are stored as soon as drawn below, hence the above being required first)
+    _pPotentialFields = new uint64[VANILLA_HTM_SHEET_2DSIZE * _uConnectivityFieldsQwordSizePerColumn];
+    _pPermanencePlanes = new uint64[VANILLA_HTM_SHEET_2DSIZE * 8u * _uConnectivityFieldsQwordSizePerColumn];
+    VANILLA_SP_SYN_PERM_TYPE tDrawnPermValues[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+#  endif
+#endif
+
     _pSegments = new Segment[VANILLA_HTM_SHEET_2DSIZE];
     Rand synRand;
     if (uSeed) // a value of 0 for uSeed (the default) will let the 'Rand' implementation choose its default seed of choice
@@ -1144,7 +2125,14 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
         uint16* pTmpBuffer = new uint16[uTotalCount];
         for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
             for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentSeg++) {
-                _initMapPotentialsGlobal(*pCurrentSeg, uX, uY, &synRand, uTotalCount, u16fast(uConnectedCount), pTmpBuffer);
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                _initMapPotentialsGlobal(*pCurrentSeg, uX, uY, &synRand, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    tDrawnPermValues);
+                _initPermanencePlanes(u16fast((uX << VANILLA_HTM_SHEET_SHIFT_DIVY) | uY), tDrawnPermValues);
+#else
+                _initMapPotentialsGlobal(*pCurrentSeg, uX, uY, &synRand, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    pCurrentSeg->_tPermValue);
+#endif
             }
         }
         delete[] pTmpBuffer;
@@ -1157,8 +2145,16 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
         uint16* pTmpBuffer = new uint16[uTotalCount];
         for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
             for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentSeg++) {
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                _initMapPotentialsLocalAlongX(*pCurrentSeg, uX, uY, &synRand, uPotentialConnectivitySideSize,
+                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    tDrawnPermValues);
+                _initPermanencePlanes(u16fast((uX << VANILLA_HTM_SHEET_SHIFT_DIVY) | uY), tDrawnPermValues);
+#else
                 _initMapPotentialsLocalAlongX(*pCurrentSeg, uX, uY, &synRand, uPotentialConnectivitySideSize,
-                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer);
+                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    pCurrentSeg->_tPermValue);
+#endif
             }
         }
         delete[] pTmpBuffer;
@@ -1172,22 +2168,69 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
         uint16* pTmpBuffer = new uint16[uTotalCount];
         for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
             for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentSeg++) {
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                _initMapPotentialsFullyLocal(*pCurrentSeg, uX, uY, &synRand, uPotentialConnectivitySideSize,
+                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    tDrawnPermValues);
+                _initPermanencePlanes(u16fast((uX << VANILLA_HTM_SHEET_SHIFT_DIVY) | uY), tDrawnPermValues);
+#else
                 _initMapPotentialsFullyLocal(*pCurrentSeg, uX, uY, &synRand, uPotentialConnectivitySideSize,
-                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer);
+                    uNumberOfInputSheets, uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    pCurrentSeg->_tPermValue);
+#endif
             }
         }
         delete[] pTmpBuffer;
     }
 
+    _pCompressIndicesAbove16Func = getCompressIndicesAbove16Func();
+    _pCompressIndicesAbove32Func = getCompressIndicesAbove32Func();
+    _pConvolveAlongLinesWrappedFunc = getConvolveAlongLinesWrappedFunc();
+    _pConvolveAcrossLinesWrappedFunc = getConvolveAcrossLinesWrappedFunc();
+    _pMaskAbove16Func = getMaskAbove16Func();
+    _pMaskAbove32Func = getMaskAbove32Func();
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED16)
+    _pUpdatePermanencesFunc = getUpdatePermanences16Func();
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FIXED8)
+    _pUpdatePermanencesFunc = getUpdatePermanences8Func();
+#elif (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    _pUpdatePermanencesFunc = getUpdateBitSlicedPermanencesFunc();
+#endif
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-    _uConnectivityFieldsQwordSizePerColumn = size_t(uNumberOfInputSheets) * uQwordsPerBinarySheet;
+    _pAndCountSetBitsPerRowFunc = getAndCountSetBitsPerRowFunc();
+    _pAndCountSetBitsPerRowGatheredFunc = getAndCountSetBitsPerRowGatheredFunc();
+    _pTmpBatchActivationLevels = new uint16[VANILLA_SP_BATCH_INPUT_TILE_SIZE * VANILLA_HTM_SHEET_2DSIZE];
+    _pTmpBatchActiveQwordOffsets = new uint32[VANILLA_SP_BATCH_INPUT_TILE_SIZE * _uInputQwordCount];
+    _pTmpBatchActiveQwordValues = new uint64[VANILLA_SP_BATCH_INPUT_TILE_SIZE * _uInputQwordCount];
+    _pTmpBatchActiveQwordCounts = new size_t[VANILLA_SP_BATCH_INPUT_TILE_SIZE];
+    // blocks of fields are kept to a multiple of the column count at same x, since windowed fields are processed per x
+    _uBatchFieldsBlockColumnCount = size_t(VANILLA_SP_BATCH_FIELDS_BLOCK_BYTES) /
+        (_uConnectivityFieldsQwordSizePerColumn * sizeof(uint64));
+    _uBatchFieldsBlockColumnCount &= ~size_t(VANILLA_HTM_SHEET_YMASK);
+    _uBatchFieldsBlockColumnCount = std::min(size_t(VANILLA_HTM_SHEET_2DSIZE),
+        std::max(size_t(VANILLA_HTM_SHEET_HEIGHT), _uBatchFieldsBlockColumnCount));
     _pConnectivityFields = new uint64[VANILLA_HTM_SHEET_2DSIZE * _uConnectivityFieldsQwordSizePerColumn];
-    uint64* pCurrentField = _pConnectivityFields;
-    pCurrentSeg = _pSegments;
-    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE;
-            uIndex++, pCurrentSeg++, pCurrentField += _uConnectivityFieldsQwordSizePerColumn) {
-        _initConnectivityField(*pCurrentSeg, pCurrentField, _uInputSheetsCount);
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+        _initConnectivityField(uIndex);
     }
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    _pStreamingPreviousInput = new uint64[_uInputQwordCount];
+    _bStreamingMode = false;
+    _bStreamingStateValid = false;
+    _pInvertedIndexStartPerCell = new uint32[(_uInputQwordCount << 6u) + 1u];
+    _pInvertedIndexCountPerCell = new uint16[_uInputQwordCount << 6u];
+    _pInvertedIndexColumns = 0;
+    _uInvertedIndexColumnsCapacity = 0u;
+    _rebuildInvertedIndex();
+#  endif
+#endif
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    _bParallelCompute = false;
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    _pTmpDeferredIndexUpdates = 0;          // allocated on first use, only if parallel mode is ever switched on
+    _pTmpDeferredIndexUpdatesCount = 0;
+    _uDeferredIndexUpdatesCapacity = 0u;
+#  endif
 #endif
 
     _uInhibitionRadius = VANILLA_HTM_SHEET_HEIGHT;
@@ -1196,16 +2239,8 @@ VanillaSP::VanillaSP(uint8 uNumberOfInputSheets, uint8 uPotentialConnectivityRad
     uMaxK_now = std::min(uMaxK_now, u16fast(VANILLA_SP_MAX_WINNERS));
     uMaxK_now = std::max(uMaxK_now, u16fast(1u));
     _uCurrentWinnerK = uMaxK_now;
-    _pTmpTableBest = new uint32[uMaxK_now + 1u];
 #ifdef VANILLA_SP_USE_LOCAL_INHIB
     _onUpdateDynamicInhibitionRange();
-#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
-#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER)
-        _pTmpGaussY = new uint32[VANILLA_HTM_SHEET_2DSIZE];
-        _pTmpGaussX = new uint32[VANILLA_HTM_SHEET_2DSIZE];
-        _pReducedActivations = new uint32[VANILLA_HTM_SHEET_2DSIZE];
-#    endif // VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSTEST or VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ENFSPACING
-#  endif // valueof VANILLA_SP_USE_LOCAL_INHIB
 #endif // VANILLA_SP_USE_LOCAL_INHIB
 
 #if defined(VANILLA_SP_DEBUG) && defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI)
@@ -1228,6 +2263,15 @@ VanillaSP::~VanillaSP()
     delete[] _pAverageOverThresholdRatioPerColumn;
     delete[] _pOverThresholdRatioTargetPerColumn;
     delete[] _pInactiveEpochsPerColumn;
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    delete[] _pOverThresholdRatioEpochPerColumn;
+    delete[] _pActiveRatioEpochPerColumn;
+#endif
+#ifdef VANILLA_SP_USE_LOCAL_INHIB
+#  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
+    delete[] _pTmpMaxFilterValues;
+#  endif
+#endif
 
     delete[] _pTmpRawActivationLevelsPerCol;
 #ifdef VANILLA_SP_USE_BOOSTING
@@ -1235,22 +2279,29 @@ VanillaSP::~VanillaSP()
     delete[] _pBoostingPerCol;
 #endif
 
-    delete[] _pTmpTableBest;
 
     delete[] _pSegments;
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
     delete[] _pConnectivityFields;
+#  if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    delete[] _pPotentialFields;
+    delete[] _pPermanencePlanes;
+#  endif
+    delete[] _pTmpBatchActivationLevels;
+    delete[] _pTmpBatchActiveQwordOffsets;
+    delete[] _pTmpBatchActiveQwordValues;
+    delete[] _pTmpBatchActiveQwordCounts;
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    delete[] _pInvertedIndexStartPerCell;
+    delete[] _pInvertedIndexCountPerCell;
+    delete[] _pInvertedIndexColumns;
+    delete[] _pStreamingPreviousInput;
+#  endif
+#endif
+#if defined(VANILLA_SP_ALLOW_PARALLEL_COMPUTE) && defined(VANILLA_SP_USE_SPARSE_INPUT_OPTI)
+    delete[] _pTmpDeferredIndexUpdates;
+    delete[] _pTmpDeferredIndexUpdatesCount;
 #endif
-
-#ifdef VANILLA_SP_USE_LOCAL_INHIB
-#if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
-#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER)
-        delete[] _pTmpGaussY;
-        delete[] _pTmpGaussX;
-        delete[] _pReducedActivations;
-#    endif // VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSTEST or VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ENFSPACING
-#  endif // valueof VANILLA_SP_USE_LOCAL_INHIB
-#endif // VANILLA_SP_USE_LOCAL_INHIB
 }
 
 // - - - - - - - - - - - - - - - - - - - -
@@ -1261,7 +2312,34 @@ void VanillaSP::_compute(const uint64* pInputBinaryBitmap, std::vector<uint16>&
 {
     vecOutputIndices.clear();
     _uEpoch++;
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    bool bIncrementalUpdate = false;
+    if (_bStreamingMode && _bStreamingStateValid) {
+        // Incremental update walks the inverted index lists of flipped cells, whereas the cheapest full computation would
+        //   walk those of active cells, or AND all connectivity fields (same cost model as _computeUnrestrictedActivationLevels)
+        uint64 uFlippedCount = 0uLL;
+        uint64 uActiveInputCount = 0uLL;
+        for (size_t uQword = 0u; uQword < _uInputQwordCount; uQword++) {
+            uFlippedCount += countSetBits64(pInputBinaryBitmap[uQword] ^ _pStreamingPreviousInput[uQword]);
+            uActiveInputCount += countSetBits64(pInputBinaryBitmap[uQword]);
+        }
+        uint64 uIncrementalCost = uFlippedCount * _uInvertedIndexTotalCount * uint64(VANILLA_SP_SPARSE_INPUT_COST_RATIO);
+        uint64 uDenseCost = uint64(VANILLA_HTM_SHEET_2DSIZE) * uint64(_uConnectivityFieldsQwordSizePerColumn) *
+            (uint64(_uInputQwordCount) << 6u);
+        bIncrementalUpdate = uFlippedCount < uActiveInputCount && uIncrementalCost < uDenseCost;
+    }
+    if (bIncrementalUpdate) {
+        _updateUnrestrictedActivationLevelsFromInputChanges(pInputBinaryBitmap, _pStreamingPreviousInput,
+            _pTmpRawActivationLevelsPerCol);
+    } else
+#endif
     _computeUnrestrictedActivationLevels(pInputBinaryBitmap, _pTmpRawActivationLevelsPerCol);
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    if (_bStreamingMode) {
+        memcpy((void*)_pStreamingPreviousInput, pInputBinaryBitmap, _uInputQwordCount * sizeof(uint64));
+        _bStreamingStateValid = true;   // ...until learning changes connectivity, if it does
+    }
+#endif
 #if defined(VANILLA_SP_USE_BOOSTING)
     _computeActiveColumnsAndLearnWhenBoosted(pInputBinaryBitmap, vecOutputIndices, bLearning, pOutputBinaryBitmap, pOutputMinActivations);
 #else
@@ -1270,6 +2348,9 @@ void VanillaSP::_compute(const uint64* pInputBinaryBitmap, std::vector<uint16>&
     if (bLearning) {
         _uEpochLearning++;
         if (0uLL == (_uEpochLearning & 0x003FuLL)) { // complex updates are called once every 64 rounds
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+            _materializeColumnUsage(_uEpochLearning, 0u, VANILLA_HTM_SHEET_2DSIZE);
+#endif
 #  if defined(VANILLA_SP_USE_LOCAL_INHIB) && !defined(VANILLA_SP_FORCE_NONLOCAL_STATS)
             _onUpdateDynamicInhibitionRange();
 #    if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
@@ -1290,30 +2371,102 @@ void VanillaSP::_compute(const uint64* pInputBinaryBitmap, std::vector<uint16>&
     }
 }
 
+// - - - - - - - - - - - - - - - - - - - -
+// VanillaSP batched inference '_computeBatch' method
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_computeBatch(const uint64* pInputBinaryBitmaps, size_t uInputCount,
+    std::vector<uint16>* pOutputIndicesPerInput, uint64* pOutputBinaryBitmaps)
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    size_t uQwordsPerInput = size_t(_uInputSheetsCount) * uQwordsPerBinarySheet;
+    std::vector<uint16>& vecTmpOutputIndices = _vecTmpOutputIndices;
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    _bStreamingStateValid = false;      // raw activation levels get overwritten by the ones of the batch
+#endif
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    for (size_t uTileStart = 0u; uTileStart < uInputCount; uTileStart += VANILLA_SP_BATCH_INPUT_TILE_SIZE) {
+        size_t uTileCount = std::min(size_t(VANILLA_SP_BATCH_INPUT_TILE_SIZE), uInputCount - uTileStart);
+        _computeUnrestrictedActivationLevelsForTile(pInputBinaryBitmaps + uTileStart * uQwordsPerInput, uTileCount,
+            _pTmpBatchActivationLevels);
+        // then selecting winners for each input in turn, exactly as a non-learning _compute() would
+        for (size_t uInTile = 0u; uInTile < uTileCount; uInTile++) {
+            size_t uInput = uTileStart + uInTile;
+            std::vector<uint16>& vecOutputIndices = pOutputIndicesPerInput ? pOutputIndicesPerInput[uInput] : vecTmpOutputIndices;
+            uint64* pOutputBinaryBitmap = pOutputBinaryBitmaps ? pOutputBinaryBitmaps + uInput * uQwordsPerBinarySheet : 0;
+            vecOutputIndices.clear();
+            _uEpoch++;
+            memcpy((void*)_pTmpRawActivationLevelsPerCol, _pTmpBatchActivationLevels + uInTile * VANILLA_HTM_SHEET_2DSIZE,
+                VANILLA_HTM_SHEET_2DSIZE * sizeof(uint16));
+#  if defined(VANILLA_SP_USE_BOOSTING)
+            _computeActiveColumnsAndLearnWhenBoosted(pInputBinaryBitmaps + uInput * uQwordsPerInput, vecOutputIndices,
+                false, pOutputBinaryBitmap, 0);
+#  else
+            _computeActiveColumnsAndLearnWhenNoBoosting(pInputBinaryBitmaps + uInput * uQwordsPerInput, vecOutputIndices,
+                false, pOutputBinaryBitmap, 0);
+#  endif
+        }
+    }
+#else
+    // without connectivity fields, there is nothing to amortize => simply one input after the other
+    for (size_t uInput = 0u; uInput < uInputCount; uInput++) {
+        _compute(pInputBinaryBitmaps + uInput * uQwordsPerInput,
+            pOutputIndicesPerInput ? pOutputIndicesPerInput[uInput] : vecTmpOutputIndices, false,
+            pOutputBinaryBitmaps ? pOutputBinaryBitmaps + uInput * uQwordsPerBinarySheet : 0, 0);
+    }
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_computeUnrestrictedActivationLevels(const uint64* pInputBinaryBitmap,
     uint16* pOutputActivationLevelsPerCol) const
 {
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-    const uint64* pCurrentConnectivityFieldQword = _pConnectivityFields;
-    const uint64 uIterCount = _uConnectivityFieldsQwordSizePerColumn;
-    for (uint16 *pCurrentColOutput = pOutputActivationLevelsPerCol,
-            *pEndOutput = pOutputActivationLevelsPerCol + VANILLA_HTM_SHEET_2DSIZE;
-            pCurrentColOutput < pEndOutput; pCurrentColOutput++) {
-        uint64 uLevelOnThisColumn = 0uLL;
-        for (const uint64 *pCurrentInputQword = pInputBinaryBitmap, *pEndInput = pInputBinaryBitmap+uIterCount;
-                pCurrentInputQword < pEndInput; pCurrentInputQword++, pCurrentConnectivityFieldQword++) {
-            uint64 uOverlapOnThisQword = (*pCurrentConnectivityFieldQword) & (*pCurrentInputQword);
-            uLevelOnThisColumn += countSetBits64(uOverlapOnThisQword);
-        }
-        *pCurrentColOutput = uint16(uLevelOnThisColumn);
+    // Most input qwords are typically zero => first building the compacted list of non-zero ones (and input popcount)
+    uint64 uActiveInputCount = 0uLL;
+    size_t uActiveQwordCount = _compactNonZeroQwords(pInputBinaryBitmap, _uInputQwordCount,
+        _scratch._pTmpActiveInputQwordOffsets, _scratch._pTmpActiveInputQwordValues, &uActiveInputCount);
+    // Gathering only those qwords from each connectivity field is preferred whenever enough of them can be skipped to make
+    //   up for the higher cost of a gather vs. a plain load
+    bool bGatherActiveQwords = uActiveQwordCount * size_t(VANILLA_SP_GATHERED_INPUT_COST_RATIO) < _uInputQwordCount;
+#  ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // Estimating the costs of both methods from input popcount: walking the inverted index requires, for each active cell,
+    //   as many increments as its fan-out (estimated on average here), while the AND-popcount way requires to process all
+    //   (or all gathered) qwords of all connectivity fields. Both sides of the comparison are multiplied by cell count.
+    //   (with windowed fields, gathered qwords are estimated as a window-sized share of the active ones)
+    static const uint64 uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    uint64 uCellCount = uint64(_uInputQwordCount) << 6u;
+    uint64 uDenseQwordCost = bGatherActiveQwords ?
+        (uint64(uActiveQwordCount) * uint64(VANILLA_SP_GATHERED_INPUT_COST_RATIO) *
+            uint64(_uConnectivityFieldsQwordSizePerSheet)) / uQwordsPerBinarySheet :
+        uint64(_uConnectivityFieldsQwordSizePerColumn);
+    uint64 uSparseCost = uActiveInputCount * _uInvertedIndexTotalCount * uint64(VANILLA_SP_SPARSE_INPUT_COST_RATIO);
+    uint64 uDenseCost = uint64(VANILLA_HTM_SHEET_2DSIZE) * uDenseQwordCost * uCellCount;
+    if (uSparseCost < uDenseCost) {
+        _computeUnrestrictedActivationLevelsFromInvertedIndex(_scratch._pTmpActiveInputQwordOffsets,
+            _scratch._pTmpActiveInputQwordValues, uActiveQwordCount, pOutputActivationLevelsPerCol);
+    } else
+#  else
+    HTMATCH_unused(uActiveInputCount);
+#  endif
+#  ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        // each slice of columns reads its own connectivity fields and writes its own outputs => no sharing at all
+        HTMATCH::for_count(HTMATCH_PAR, 0u, VANILLA_HTM_SHEET_2DSIZE / VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE,
+                [this, pInputBinaryBitmap, bGatherActiveQwords, uActiveQwordCount, pOutputActivationLevelsPerCol](u32fast uSlice) {
+            _computeUnrestrictedActivationLevelsOnColumnRange(pInputBinaryBitmap, _scratch._pTmpActiveInputQwordOffsets,
+                _scratch._pTmpActiveInputQwordValues, uActiveQwordCount, bGatherActiveQwords,
+                size_t(uSlice) * VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE, VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE,
+                pOutputActivationLevelsPerCol);
+        });
+    } else
+#  endif
+    _computeUnrestrictedActivationLevelsOnColumnRange(pInputBinaryBitmap, _scratch._pTmpActiveInputQwordOffsets,
+        _scratch._pTmpActiveInputQwordValues, uActiveQwordCount, bGatherActiveQwords, 0u, VANILLA_HTM_SHEET_2DSIZE,
+        pOutputActivationLevelsPerCol);
 #  if defined(VANILLA_SP_DEBUG)
-        if (pCurrentColOutput == pOutputActivationLevelsPerCol) {
-            std::cout << "@Iter " << _uEpoch << ", first cell raw activation=" << uLevelOnThisColumn << std::endl;
-        }
+    std::cout << "@Iter " << _uEpoch << ", first cell raw activation=" << pOutputActivationLevelsPerCol[0] << std::endl;
 #  endif
-    }
 #else
     const Segment *pCurrentSeg = _pSegments;
     for (uint16 *pCurrentColOutput = pOutputActivationLevelsPerCol,
@@ -1336,6 +2489,239 @@ void VanillaSP::_computeUnrestrictedActivationLevels(const uint64* pInputBinaryB
 #endif
 }
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSPInferenceCore::_computeUnrestrictedActivationLevelsOnColumnRange(const uint64* pInputBinaryBitmap,
+    const uint32* pActiveQwordOffsets, const uint64* pActiveQwordValues, size_t uActiveQwordCount, bool bGatherActiveQwords,
+    size_t uColumnStart, size_t uColumnCount, uint16* pOutputActivationLevelsPerCol) const
+{
+#ifdef VANILLA_SP_USE_WINDOWED_CONNECTIVITY_FIELDS
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    if (_uConnectivityFieldsQwordSizePerSheet < uQwordsPerBinarySheet) {
+        // Windowed fields: all columns at same x share the same window => for each x, first extracting the windowed input
+        //   (with wrap-around) and its compacted list of non-zero qwords, then calling one of the kernels on those columns.
+        //   Column ranges are always multiples of the column count at same x. Compacted full input is not used here.
+        HTMATCH_unused(pActiveQwordOffsets);
+        HTMATCH_unused(pActiveQwordValues);
+        HTMATCH_unused(uActiveQwordCount);
+        HTMATCH_unused(bGatherActiveQwords);
+        uint64 tWindowedInput[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+        uint32 tWindowedActiveQwordOffsets[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+        uint64 tWindowedActiveQwordValues[VANILLA_HTM_SHEET_MAX_DEPTH * uQwordsPerBinarySheet];
+        for (size_t uX = uColumnStart >> VANILLA_HTM_SHEET_SHIFT_DIVY,
+                uEndX = (uColumnStart + uColumnCount) >> VANILLA_HTM_SHEET_SHIFT_DIVY; uX < uEndX; uX++) {
+            size_t uWindowStartQword = _getConnectivityWindowStartQword(u16fast(uX));
+            uint64* pCurrentWindowed = tWindowedInput;
+            for (const uint64 *pSheetInput = pInputBinaryBitmap, *pEndInput = pInputBinaryBitmap + _uInputQwordCount;
+                    pSheetInput < pEndInput; pSheetInput += uQwordsPerBinarySheet) {
+                for (size_t uPos = 0u; uPos < _uConnectivityFieldsQwordSizePerSheet; uPos++, pCurrentWindowed++) {
+                    *pCurrentWindowed = pSheetInput[(uWindowStartQword + uPos) & (uQwordsPerBinarySheet - 1u)];
+                }
+            }
+            uint64 uUnusedSetBitsCount = 0uLL;
+            size_t uWindowedActiveQwordCount = _compactNonZeroQwords(tWindowedInput, _uConnectivityFieldsQwordSizePerColumn,
+                tWindowedActiveQwordOffsets, tWindowedActiveQwordValues, &uUnusedSetBitsCount);
+            size_t uFirstColumn = uX << VANILLA_HTM_SHEET_SHIFT_DIVY;
+            const uint64* pFirstField = _pConnectivityFields + uFirstColumn * _uConnectivityFieldsQwordSizePerColumn;
+            if (uWindowedActiveQwordCount * size_t(VANILLA_SP_GATHERED_INPUT_COST_RATIO) <
+                    _uConnectivityFieldsQwordSizePerColumn) {
+                _pAndCountSetBitsPerRowGatheredFunc(pFirstField, _uConnectivityFieldsQwordSizePerColumn,
+                    VANILLA_HTM_SHEET_HEIGHT, tWindowedActiveQwordOffsets, tWindowedActiveQwordValues,
+                    uWindowedActiveQwordCount, pOutputActivationLevelsPerCol + uFirstColumn);
+            } else {
+                _pAndCountSetBitsPerRowFunc(pFirstField, tWindowedInput, _uConnectivityFieldsQwordSizePerColumn,
+                    VANILLA_HTM_SHEET_HEIGHT, pOutputActivationLevelsPerCol + uFirstColumn);
+            }
+        }
+        return;
+    }
+#endif
+    // AND-then-popcount of each column's connectivity field against the input bitfield, as a single call to one of the
+    //   vectorized kernels which were selected at construction time (AVX-512 VPOPCNTDQ, AVX2, or scalar fallback)
+    const uint64* pFirstField = _pConnectivityFields + uColumnStart * _uConnectivityFieldsQwordSizePerColumn;
+    if (bGatherActiveQwords) {
+        _pAndCountSetBitsPerRowGatheredFunc(pFirstField, _uConnectivityFieldsQwordSizePerColumn, uColumnCount,
+            pActiveQwordOffsets, pActiveQwordValues, uActiveQwordCount, pOutputActivationLevelsPerCol + uColumnStart);
+    } else {
+        _pAndCountSetBitsPerRowFunc(pFirstField, pInputBinaryBitmap, _uConnectivityFieldsQwordSizePerColumn,
+            uColumnCount, pOutputActivationLevelsPerCol + uColumnStart);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_computeUnrestrictedActivationLevelsForTile(const uint64* pInputBinaryBitmaps, size_t uInputCount,
+    uint16* pOutputActivationLevelsPerInput) const
+{
+    // compacting all inputs of the tile first (the inverted index way is not considered here, since the whole point of
+    //   batching is to amortize the streaming of connectivity fields over several inputs)
+    for (size_t uInput = 0u; uInput < uInputCount; uInput++) {
+        uint64 uUnusedSetBitsCount = 0uLL;
+        _pTmpBatchActiveQwordCounts[uInput] = _compactNonZeroQwords(
+            pInputBinaryBitmaps + uInput * _uInputQwordCount, _uInputQwordCount,
+            _pTmpBatchActiveQwordOffsets + uInput * _uInputQwordCount,
+            _pTmpBatchActiveQwordValues + uInput * _uInputQwordCount, &uUnusedSetBitsCount);
+    }
+    size_t uBlockCount = (size_t(VANILLA_HTM_SHEET_2DSIZE) + _uBatchFieldsBlockColumnCount - 1u) / _uBatchFieldsBlockColumnCount;
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        HTMATCH::for_count(HTMATCH_PAR, 0u, u32fast(uBlockCount),
+                [this, pInputBinaryBitmaps, uInputCount, pOutputActivationLevelsPerInput](u32fast uBlock) {
+            size_t uColumnStart = size_t(uBlock) * _uBatchFieldsBlockColumnCount;
+            _computeUnrestrictedActivationLevelsForTileOnColumnRange(pInputBinaryBitmaps, uInputCount, uColumnStart,
+                std::min(_uBatchFieldsBlockColumnCount, size_t(VANILLA_HTM_SHEET_2DSIZE) - uColumnStart),
+                pOutputActivationLevelsPerInput);
+        });
+        return;
+    }
+#endif
+    for (size_t uBlock = 0u; uBlock < uBlockCount; uBlock++) {
+        size_t uColumnStart = uBlock * _uBatchFieldsBlockColumnCount;
+        _computeUnrestrictedActivationLevelsForTileOnColumnRange(pInputBinaryBitmaps, uInputCount, uColumnStart,
+            std::min(_uBatchFieldsBlockColumnCount, size_t(VANILLA_HTM_SHEET_2DSIZE) - uColumnStart),
+            pOutputActivationLevelsPerInput);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_computeUnrestrictedActivationLevelsForTileOnColumnRange(const uint64* pInputBinaryBitmaps,
+    size_t uInputCount, size_t uColumnStart, size_t uColumnCount, uint16* pOutputActivationLevelsPerInput) const
+{
+    // this block of fields gets loaded from memory for the first input, and hopefully stays in cache for all others
+    for (size_t uInput = 0u; uInput < uInputCount; uInput++) {
+        size_t uActiveQwordCount = _pTmpBatchActiveQwordCounts[uInput];
+        bool bGatherActiveQwords = uActiveQwordCount * size_t(VANILLA_SP_GATHERED_INPUT_COST_RATIO) < _uInputQwordCount;
+        _computeUnrestrictedActivationLevelsOnColumnRange(
+            pInputBinaryBitmaps + uInput * _uInputQwordCount,
+            _pTmpBatchActiveQwordOffsets + uInput * _uInputQwordCount,
+            _pTmpBatchActiveQwordValues + uInput * _uInputQwordCount,
+            uActiveQwordCount, bGatherActiveQwords, uColumnStart, uColumnCount,
+            pOutputActivationLevelsPerInput + uInput * VANILLA_HTM_SHEET_2DSIZE);
+    }
+}
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_computeUnrestrictedActivationLevelsFromInvertedIndex(const uint32* pActiveQwordOffsets,
+    const uint64* pActiveQwordValues, size_t uActiveQwordCount, uint16* pOutputActivationLevelsPerCol) const
+{
+    memset((void*)pOutputActivationLevelsPerCol, 0, VANILLA_HTM_SHEET_2DSIZE * sizeof(uint16));
+    for (size_t uActiveQword = 0u; uActiveQword < uActiveQwordCount; uActiveQword++) {
+        size_t uQwordStartIndex = size_t(pActiveQwordOffsets[uActiveQword]) << 6u;
+        uint64 uRemainingBits = pActiveQwordValues[uActiveQword];
+        while (uRemainingBits) {
+            size_t uCellIndex = uQwordStartIndex | size_t(getTrailingZeroesCount64(uRemainingBits));
+            uRemainingBits &= uRemainingBits - 1uLL;
+            const uint16* pCurrentCol = _pInvertedIndexColumns + _pInvertedIndexStartPerCell[uCellIndex];
+            for (const uint16* pEndCol = pCurrentCol + _pInvertedIndexCountPerCell[uCellIndex]; pCurrentCol < pEndCol;
+                    pCurrentCol++) {
+                pOutputActivationLevelsPerCol[*pCurrentCol]++;
+            }
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_updateUnrestrictedActivationLevelsFromInputChanges(const uint64* pInputBinaryBitmap,
+    const uint64* pPreviousInputBinaryBitmap, uint16* pInOutActivationLevelsPerCol) const
+{
+    for (size_t uQword = 0u; uQword < _uInputQwordCount; uQword++) {
+        uint64 uCurrentBits = pInputBinaryBitmap[uQword];
+        uint64 uRemainingFlippedBits = uCurrentBits ^ pPreviousInputBinaryBitmap[uQword];
+        size_t uQwordStartIndex = uQword << 6u;
+        while (uRemainingFlippedBits) {
+            u16fast uBit = u16fast(getTrailingZeroesCount64(uRemainingFlippedBits));
+            uRemainingFlippedBits &= uRemainingFlippedBits - 1uLL;
+            size_t uCellIndex = uQwordStartIndex | size_t(uBit);
+            const uint16* pCurrentCol = _pInvertedIndexColumns + _pInvertedIndexStartPerCell[uCellIndex];
+            const uint16* pEndCol = pCurrentCol + _pInvertedIndexCountPerCell[uCellIndex];
+            if ((uCurrentBits >> uBit) & 1uLL) {
+                for (; pCurrentCol < pEndCol; pCurrentCol++) {      // cell turned on
+                    pInOutActivationLevelsPerCol[*pCurrentCol]++;
+                }
+            } else {
+                for (; pCurrentCol < pEndCol; pCurrentCol++) {      // cell turned off
+                    pInOutActivationLevelsPerCol[*pCurrentCol]--;
+                }
+            }
+        }
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_rebuildInvertedIndex()
+{
+    _bStreamingStateValid = false;
+    size_t uCellCount = _uInputQwordCount << 6u;
+
+    // First pass: max possible fan-out of each cell is its number of potential synapses (counted in-place in start offsets)
+    memset((void*)_pInvertedIndexStartPerCell, 0, (uCellCount + 1u) * sizeof(uint32));
+    const Segment* pCurrentSeg = _pSegments;
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentSeg++) {
+        const uint16* pPreSyn = pCurrentSeg->_tPreSynIndex;
+        for (const uint16* pEndPreSyn = pPreSyn + pCurrentSeg->_uCount; pPreSyn < pEndPreSyn; pPreSyn++) {
+            _pInvertedIndexStartPerCell[*pPreSyn]++;
+        }
+    }
+#ifdef VANILLA_SP_ALLOW_REROLLS
+    // partial rerolls may leave connectivity bits which are not backed by any potential synapse => accounting for those too
+    const uint64* pCurrentFieldQword = _pConnectivityFields;
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+        for (size_t uQword = 0u; uQword < _uConnectivityFieldsQwordSizePerColumn; uQword++, pCurrentFieldQword++) {
+            uint64 uRemainingBits = *pCurrentFieldQword;
+            while (uRemainingBits) {
+                _pInvertedIndexStartPerCell[_getPreSynCellIndexFromFieldPos(uIndex, uQword,
+                    u16fast(getTrailingZeroesCount64(uRemainingBits)))]++;
+                uRemainingBits &= uRemainingBits - 1uLL;
+            }
+        }
+    }
+#endif
+    uint32 uTotalCapacity = 0u;
+    for (uint32 *pCurrentStart = _pInvertedIndexStartPerCell, *pEndStart = _pInvertedIndexStartPerCell + uCellCount;
+            pCurrentStart < pEndStart; pCurrentStart++) {
+        uint32 uCapacityThisCell = *pCurrentStart;
+        *pCurrentStart = uTotalCapacity;
+        uTotalCapacity += uCapacityThisCell;
+    }
+    _pInvertedIndexStartPerCell[uCellCount] = uTotalCapacity;
+    if (uTotalCapacity > _uInvertedIndexColumnsCapacity) {  // only ever reallocated when growing (rerolls may call us again)
+        delete[] _pInvertedIndexColumns;
+        _pInvertedIndexColumns = new uint16[uTotalCapacity];
+        _uInvertedIndexColumnsCapacity = uTotalCapacity;
+    }
+
+    // Second pass: filling the lists from the connectivity fields themselves
+    memset((void*)_pInvertedIndexCountPerCell, 0, uCellCount * sizeof(uint16));
+    _uInvertedIndexTotalCount = 0uLL;
+    const uint64* pCurrentField = _pConnectivityFields;
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentField += _uConnectivityFieldsQwordSizePerColumn) {
+        for (size_t uQword = 0u; uQword < _uConnectivityFieldsQwordSizePerColumn; uQword++) {
+            uint64 uRemainingBits = pCurrentField[uQword];
+            while (uRemainingBits) {
+                size_t uCellIndex = _getPreSynCellIndexFromFieldPos(uIndex, uQword,
+                    u16fast(getTrailingZeroesCount64(uRemainingBits)));
+                uRemainingBits &= uRemainingBits - 1uLL;
+                _pInvertedIndexColumns[_pInvertedIndexStartPerCell[uCellIndex] + _pInvertedIndexCountPerCell[uCellIndex]] =
+                    uint16(uIndex);
+                _pInvertedIndexCountPerCell[uCellIndex]++;
+                _uInvertedIndexTotalCount++;
+            }
+        }
+    }
+}
+
+#endif // VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
 
 #ifdef VANILLA_SP_USE_BOOSTING
 
@@ -1344,12 +2730,20 @@ void VanillaSP::_computeUnrestrictedActivationLevels(const uint64* pInputBinaryB
 void VanillaSP::_computeBoostedActivationLevels(const uint16* pActivationLevelsPerCol,
         uint32* pOutputBoostedActivationLevelsPerCol) const
 {
-    uint32* pCurrentColOutput = pOutputBoostedActivationLevelsPerCol;
-    const uint16* pCurrentColBoosting = _pBoostingPerCol;
-    for (const uint16 *pCurrentColInput = pActivationLevelsPerCol, *pEndInput = pActivationLevelsPerCol+VANILLA_HTM_SHEET_2DSIZE;
-        pCurrentColInput < pEndInput; pCurrentColInput++, pCurrentColBoosting++, pCurrentColOutput++) {
-        *pCurrentColOutput = uint32(*pCurrentColInput) * uint32(*pCurrentColBoosting);
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        const uint16* pBoostingPerCol = _pBoostingPerCol;
+        HTMATCH::for_count(HTMATCH_PAR, 0u, VANILLA_HTM_SHEET_2DSIZE / VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE,
+                [pActivationLevelsPerCol, pBoostingPerCol, pOutputBoostedActivationLevelsPerCol](u32fast uSlice) {
+            size_t uColumnStart = size_t(uSlice) * VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE;
+            _applyBoostFactors(pActivationLevelsPerCol + uColumnStart, pBoostingPerCol + uColumnStart,
+                VANILLA_SP_PARALLEL_COLUMN_SLICE_SIZE, pOutputBoostedActivationLevelsPerCol + uColumnStart);
+        });
+        return;
     }
+#endif
+    _applyBoostFactors(pActivationLevelsPerCol, _pBoostingPerCol, VANILLA_HTM_SHEET_2DSIZE,
+        pOutputBoostedActivationLevelsPerCol);
 }
 
 // - - - - - - - - - - - - - - - - - - - -
@@ -1374,32 +2768,33 @@ void VanillaSP::_computeActiveColumnsAndLearnWhenBoosted(const uint64* pInputBin
     std::vector<uint16>& vecOutputIndices, bool bLearning, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations)
 {
     _computeBoostedActivationLevels(_pTmpRawActivationLevelsPerCol, _pTmpBoostedActivationLevelsPerCol);
-    _getActiveColumnsFromActivationLevels(_pTmpBoostedActivationLevelsPerCol, vecOutputIndices, pOutputMinActivations);
-    if (bLearning || pOutputBinaryBitmap) {
-        if (!pOutputBinaryBitmap)
-            pOutputBinaryBitmap = _pTmpBinaryOutputBuffer;
-        SDRTools::toBinaryBitmap64(vecOutputIndices, pOutputBinaryBitmap, VANILLA_HTM_SHEET_BYTES_BINARY);
-        if (bLearning) {
-            _updateSynapsesOnActiveColumnsTowardsCurrentInput(pInputBinaryBitmap, vecOutputIndices);
-            _onEvaluateColumnUsage(_pTmpRawActivationLevelsPerCol, pOutputBinaryBitmap);
-            if (17u == (_uEpoch & 0x0000001FuLL)) {
-                _onIncreasePermanencesForUnderUsedColums();
+    if (!pOutputBinaryBitmap)
+        pOutputBinaryBitmap = _pTmpBinaryOutputBuffer;
+    _getActiveColumnsFromActivationLevels(_pTmpBoostedActivationLevelsPerCol, vecOutputIndices, pOutputBinaryBitmap,
+        pOutputMinActivations, _scratch);
+    if (bLearning) {
+        _updateSynapsesOnActiveColumnsTowardsCurrentInput(pInputBinaryBitmap, vecOutputIndices);
+        _onEvaluateColumnUsage(_pTmpRawActivationLevelsPerCol, pOutputBinaryBitmap);
+        _onMaintainUnderUsedColumns(5u, 17u);
+        if (17u == (_uEpoch & 0x0000001FuLL)) {
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+            _materializeColumnUsage(_uEpochLearning + 1u, 0u, VANILLA_HTM_SHEET_2DSIZE);  // (not yet increased for current step)
+#endif
 #  if defined(VANILLA_SP_USE_LOCAL_INHIB) && !defined(VANILLA_SP_FORCE_NONLOCAL_STATS)
 #    if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
-                if (_uInhibitionSideSize < VANILLA_SP_MIN_AREA_SIDE_SIZE || _uInhibitionSideSize >= VANILLA_HTM_SHEET_WIDTH) {
-                    _onEvaluateBoostingFromColumnUsageWithGlobalInhib();
-                } else if (_uInhibitionSideSize >= VANILLA_HTM_SHEET_HEIGHT) {
-                    _onEvaluateBoostingFromColumnUsageWithLocalInhibAlongX();
-                } else {
-                    _onEvaluateBoostingFromColumnUsageWithFullLocalInhib();
-                }
+            if (_uInhibitionSideSize < VANILLA_SP_MIN_AREA_SIDE_SIZE || _uInhibitionSideSize >= VANILLA_HTM_SHEET_WIDTH) {
+                _onEvaluateBoostingFromColumnUsageWithGlobalInhib();
+            } else if (_uInhibitionSideSize >= VANILLA_HTM_SHEET_HEIGHT) {
+                _onEvaluateBoostingFromColumnUsageWithLocalInhibAlongX();
+            } else {
+                _onEvaluateBoostingFromColumnUsageWithFullLocalInhib();
+            }
 #    else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
-                _onEvaluateBoostingFromColumnUsageWithBucketInhib();
+            _onEvaluateBoostingFromColumnUsageWithBucketInhib();
 #    endif // value of VANILLA_SP_USE_LOCAL_INHIB 
 #  else  // !VANILLA_SP_USE_LOCAL_INHIB || VANILLA_SP_FORCE_NONLOCAL_STATS
-                _onEvaluateBoostingFromColumnUsageWithGlobalInhib();
+            _onEvaluateBoostingFromColumnUsageWithGlobalInhib();
 #  endif // VANILLA_SP_USE_LOCAL_INHIB
-            }
         }
     }
 }
@@ -1411,18 +2806,14 @@ void VanillaSP::_computeActiveColumnsAndLearnWhenBoosted(const uint64* pInputBin
 void VanillaSP::_computeActiveColumnsAndLearnWhenNoBoosting(const uint64* pInputBinaryBitmap,
     std::vector<uint16>& vecOutputIndices, bool bLearning, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations)
 {
-    _getActiveColumnsFromActivationLevels(_pTmpRawActivationLevelsPerCol, vecOutputIndices, pOutputMinActivations);
-    if (bLearning || pOutputBinaryBitmap) {
-        if (!pOutputBinaryBitmap)
-            pOutputBinaryBitmap = _pTmpBinaryOutputBuffer;
-        SDRTools::toBinaryBitmap64(vecOutputIndices, pOutputBinaryBitmap, VANILLA_HTM_SHEET_BYTES_BINARY);
-        if (bLearning) {
-            _updateSynapsesOnActiveColumnsTowardsCurrentInput(pInputBinaryBitmap, vecOutputIndices);
-            _onEvaluateColumnUsage(_pTmpRawActivationLevelsPerCol, pOutputBinaryBitmap);
-            if (33u == (_uEpoch & 0x0000003FuLL)) {
-                _onIncreasePermanencesForUnderUsedColums();
-            }
-        }
+    if (!pOutputBinaryBitmap)
+        pOutputBinaryBitmap = _pTmpBinaryOutputBuffer;
+    _getActiveColumnsFromActivationLevels(_pTmpRawActivationLevelsPerCol, vecOutputIndices, pOutputBinaryBitmap,
+        pOutputMinActivations, _scratch);
+    if (bLearning) {
+        _updateSynapsesOnActiveColumnsTowardsCurrentInput(pInputBinaryBitmap, vecOutputIndices);
+        _onEvaluateColumnUsage(_pTmpRawActivationLevelsPerCol, pOutputBinaryBitmap);
+        _onMaintainUnderUsedColumns(6u, 33u);
     }
 }
 
@@ -1441,9 +2832,18 @@ void VanillaSP::_onUpdateDynamicInhibitionRange() {
     // somewhat contrived... to get same behavior as vanilla SP
     float fAvgConnectedSpan = 0.0f;
     const Segment* pCurrentSeg = _pSegments;
+#  if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    VANILLA_SP_SYN_PERM_TYPE tPermValues[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+#  endif
     for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
         for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentSeg++) {
-            fAvgConnectedSpan += _computeCorrectedAvgConnectedSpanFor(uX, uY, _uInputSheetsCount, *pCurrentSeg);
+#  if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+            _gatherPermanencesFromPlanes(u16fast((uX << VANILLA_HTM_SHEET_SHIFT_DIVY) | uY), tPermValues);
+            const VANILLA_SP_SYN_PERM_TYPE* pPermValues = tPermValues;
+#  else
+            const VANILLA_SP_SYN_PERM_TYPE* pPermValues = pCurrentSeg->_tPermValue;
+#  endif
+            fAvgConnectedSpan += _computeCorrectedAvgConnectedSpanFor(uX, uY, _uInputSheetsCount, *pCurrentSeg, pPermValues);
         }
     }
     fAvgConnectedSpan /= float(VANILLA_HTM_SHEET_2DSIZE);
@@ -1491,43 +2891,52 @@ void VanillaSP::_onUpdateDynamicInhibitionRange() {
     u16fast uMaxK_now = u16fast(std::round(float(uCompetitorsCount) * _fActivationDensityRatio));
     uMaxK_now = std::min(uMaxK_now, u16fast(VANILLA_SP_MAX_WINNERS));
     uMaxK_now = std::max(uMaxK_now, u16fast(1u));
-    if (uMaxK_now != _uCurrentWinnerK) {
-        delete[] _pTmpTableBest;
-        _pTmpTableBest = new uint32[uMaxK_now + 1u];
-        _uCurrentWinnerK = size_t(uMaxK_now);
-    }
+    _uCurrentWinnerK = size_t(uMaxK_now);
 }
 
 #  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
 
-#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER)
+#    if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+        (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
 
 template<typename ActivationLevelType, bool bOutputMinActivation>
-void VanillaSP::_reduceActivationsByGaussianFilter(const ActivationLevelType* pActivationLevelsPerCol,
-    uint32* pOutputMinActivation)
+void VanillaSPInferenceCore::_reduceActivationsByGaussianFilter(const ActivationLevelType* pActivationLevelsPerCol,
+    uint32* pOutputMinActivation, VanillaSPScratch& scratch) const
 {
     if (bOutputMinActivation) {
         std::memset((void*)pOutputMinActivation, 0, sizeof(uint32_t)*VANILLA_HTM_SHEET_2DSIZE);
     }
-    _computeGaussian<ActivationLevelType, bOutputMinActivation>(pActivationLevelsPerCol, _pTmpGaussY, _pTmpGaussX,
-        pOutputMinActivation);
+#if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    _computeBoxGaussian<ActivationLevelType, bOutputMinActivation>(pActivationLevelsPerCol, scratch._pTmpGaussY,
+        scratch._pTmpGaussX, pOutputMinActivation);
+#else
+    _computeGaussian<ActivationLevelType, bOutputMinActivation>(pActivationLevelsPerCol, scratch._pTmpGaussY,
+        scratch._pTmpGaussX, pOutputMinActivation, _pConvolveAlongLinesWrappedFunc, _pConvolveAcrossLinesWrappedFunc);
+#endif
 #if defined(VANILLA_SP_USE_BOOSTING) && defined(VANILLA_SP_GAUSS_INVBOOST_INHIB)
     u16fast uCurrentCount = _reduceByAmountPointwiseInvScaled<ActivationLevelType>(pActivationLevelsPerCol, _pBoostingPerCol,
-        _pTmpGaussX, _pReducedActivations);
+        scratch._pTmpGaussX, scratch._pReducedActivations);
 #else
-    u16fast uCurrentCount = _reduceByAmount<ActivationLevelType>(pActivationLevelsPerCol, _pTmpGaussX, _pReducedActivations);
+    u16fast uCurrentCount = _reduceByAmount<ActivationLevelType>(pActivationLevelsPerCol, scratch._pTmpGaussX,
+        scratch._pReducedActivations);
 #endif
     if (uCurrentCount >= 42) {
         // usually we won't have reached target sparsity 2% (41 active) in only one reduction-by-gaussian filter,
         //   so we still have VANILLA_SP_MAX_GAUSSIAN_ITER-1 to get closer to it
         for (u16fast uIterateMore = 1u; uIterateMore < VANILLA_SP_MAX_GAUSSIAN_ITER; uIterateMore++) {
-            _computeGaussian<uint32, bOutputMinActivation>(_pReducedActivations, _pTmpGaussY, _pTmpGaussX,
-                pOutputMinActivation);
+#if (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+            _computeBoxGaussian<uint32, bOutputMinActivation>(scratch._pReducedActivations, scratch._pTmpGaussY,
+                scratch._pTmpGaussX, pOutputMinActivation);
+#else
+            _computeGaussian<uint32, bOutputMinActivation>(scratch._pReducedActivations, scratch._pTmpGaussY,
+                scratch._pTmpGaussX, pOutputMinActivation, _pConvolveAlongLinesWrappedFunc, _pConvolveAcrossLinesWrappedFunc);
+#endif
 #if defined(VANILLA_SP_USE_BOOSTING) && defined(VANILLA_SP_GAUSS_INVBOOST_INHIB)
-            uCurrentCount = _reduceByAmountPointwiseInvScaled<uint32>(_pReducedActivations, _pBoostingPerCol,
-                _pTmpGaussX, _pReducedActivations);
+            uCurrentCount = _reduceByAmountPointwiseInvScaled<uint32>(scratch._pReducedActivations, _pBoostingPerCol,
+                scratch._pTmpGaussX, scratch._pReducedActivations);
 #else
-            uCurrentCount = _reduceByAmount<uint32>(_pReducedActivations, _pTmpGaussX, _pReducedActivations);
+            uCurrentCount = _reduceByAmount<uint32>(scratch._pReducedActivations, scratch._pTmpGaussX,
+                scratch._pReducedActivations);
 #endif
             if (uCurrentCount < 42u) {
                 break;
@@ -1537,29 +2946,37 @@ void VanillaSP::_reduceActivationsByGaussianFilter(const ActivationLevelType* pA
 #ifdef VANILLA_SP_GAUSSIAN_SCALE_TARGET
     if (uCurrentCount >= VANILLA_SP_GAUSSIAN_SCALE_TARGET) {
         // usually iterative reduction at weight 1 by gaussian filter won't be enough still,
-        //   so we now try to reduce by reusing last gaussian filter at increased reduction weight
+        //   so we now reduce by reusing last gaussian filter at increased reduction weight
         // Note that we may not try for the '41' value, though... since we'd prefer to use a more suitable method to do
         //   the last few trimming steps (here we depend on VANILLA_SP_GAUSSIAN_SCALE_TARGET)
-        uint32 tTmpReduced[VANILLA_HTM_SHEET_2DSIZE];
-        std::memcpy((void*)tTmpReduced, _pReducedActivations, sizeof(uint32_t)*VANILLA_HTM_SHEET_2DSIZE);
-        uint32 uScale8bAfterPoint = 256u;
-        uint32 uScaleIncrease = 64u;
-        do {
-            uScale8bAfterPoint += uScaleIncrease;
-            u16fast uCountNow = _reduceByAmountScaled(tTmpReduced, _pTmpGaussX, uScale8bAfterPoint, _pReducedActivations);
-            if (uCountNow < 39u) {
-                if (uScaleIncrease > 1u) {
-                    uScale8bAfterPoint -= uScaleIncrease;
-                    uScaleIncrease >>= 1u;
-                } else {
-                    uCurrentCount = uCountNow;
-                }
-            } else {
-                uCurrentCount = uCountNow;
+        // Each column stays non-negative up to a critical scale, (activation+1)*256-1 / reduction (8b after point) ;
+        //   the smallest scale leaving less than VANILLA_SP_GAUSSIAN_SCALE_TARGET columns is thus one above the
+        //   VANILLA_SP_GAUSSIAN_SCALE_TARGET-th highest critical scale, which we find in one pass with nth_element
+        //   instead of searching for it by repeated reduction passes.
+        uint32 uScale8bAfterPoint = 257u;
+        uint32 tCriticalScales[VANILLA_HTM_SHEET_2DSIZE];
+        u16fast uCandidateCount = 0u;
+        const uint32* pCurrentActivation = scratch._pReducedActivations;
+        const uint32* pCurrentGauss = scratch._pTmpGaussX;
+        for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentActivation++, pCurrentGauss++) {
+            uint64 uLimit = (uint64(*pCurrentActivation) << 8u) + 255u;
+            uint64 uReduction = *pCurrentGauss;
+            if (uint64(uScale8bAfterPoint) * uReduction <= uLimit) {    // otherwise already zeroed at lowest scale
+                uint64 uCritical = uReduction ? (uLimit / uReduction) : 0x7FFFFFFEuLL;
+                tCriticalScales[uCandidateCount] = (uCritical < 0x7FFFFFFEuLL) ? uint32(uCritical) : 0x7FFFFFFEu;
+                uCandidateCount++;
             }
-        } while (uCurrentCount >= VANILLA_SP_GAUSSIAN_SCALE_TARGET);
+        }
+        if (uCandidateCount >= VANILLA_SP_GAUSSIAN_SCALE_TARGET) {
+            uint32* pNth = tCriticalScales + (VANILLA_SP_GAUSSIAN_SCALE_TARGET - 1u);
+            std::nth_element(tCriticalScales, pNth, tCriticalScales + uCandidateCount, std::greater<uint32>());
+            uScale8bAfterPoint = *pNth + 1u;
+        }
+        // NB : reducing in place is fine, _reduceByAmountScaled reads each level before writing it back
+        uCurrentCount = _reduceByAmountScaled(scratch._pReducedActivations, scratch._pTmpGaussX, uScale8bAfterPoint,
+            scratch._pReducedActivations);
         if (bOutputMinActivation) {
-            const uint32* pCurrentReduction = _pTmpGaussX;
+            const uint32* pCurrentReduction = scratch._pTmpGaussX;
             uint32* pCurrentMin = pOutputMinActivation;
             for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentReduction++, pCurrentMin++) {
                 *pCurrentMin += ((*pCurrentReduction) * uScale8bAfterPoint) >> 8u;
@@ -1575,23 +2992,55 @@ void VanillaSP::_reduceActivationsByGaussianFilter(const ActivationLevelType* pA
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ActivationLevelType, bool bOutputMinActivation>
-void VanillaSP::_getActiveColumnsFromActivationLevelsWithLocalInhibAlongX(const ActivationLevelType* pActivationLevelsPerCol,
-    std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations)
+void VanillaSPInferenceCore::_getActiveColumnsFromActivationLevelsWithLocalInhibAlongX(const ActivationLevelType* pActivationLevelsPerCol,
+    std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+    VanillaSPScratch& scratch) const
 {
     // Stored column-major => use it to our advantage by only computing neighborhood best at columns
     u16fast uIndex = 0u;
     u16fast uXstartOffset = u16fast(_uInhibitionRadius);
     u16fast uXsize = 1u + uXstartOffset*2u;
+#ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+    // Sliding-window histogram: each step along x removes one column from the window and adds another
+    uint16* pFineCounts = scratch._pTmpHistogramFineCounts;
+    uint16* pCoarseCounts = scratch._pTmpHistogramCoarseCounts;
+    std::fill(pFineCounts, pFineCounts + (VANILLA_SP_HISTOGRAM_COARSE_COUNT << VANILLA_SP_HISTOGRAM_COARSE_SHIFT), uint16(0u));
+    std::fill(pCoarseCounts, pCoarseCounts + VANILLA_SP_HISTOGRAM_COARSE_COUNT, uint16(0u));
+    u16fast uTotalCount = 0u;
+    uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
+    for (u16fast uRelX = 0u; uRelX < uXsize; uRelX++) {
+        u16fast uCandidateX = (uRelX - uXstartOffset) & VANILLA_HTM_SHEET_XMASK;
+        _updateLevelHistogram<ActivationLevelType, true>(pActivationLevelsPerCol + (uCandidateX << VANILLA_HTM_SHEET_SHIFT_DIVY),
+            VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+    }
+#else
     u16fast uTableSize = u16fast(_uCurrentWinnerK) + 1u;
+#endif
     for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
+#ifdef VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB
+        if (uX) {
+            u16fast uLeavingX = (uX - uXstartOffset - 1u) & VANILLA_HTM_SHEET_XMASK;
+            u16fast uEnteringX = (uX + uXstartOffset) & VANILLA_HTM_SHEET_XMASK;
+            _updateLevelHistogram<ActivationLevelType, false>(pActivationLevelsPerCol + (uLeavingX << VANILLA_HTM_SHEET_SHIFT_DIVY),
+                VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+            _updateLevelHistogram<ActivationLevelType, true>(pActivationLevelsPerCol + (uEnteringX << VANILLA_HTM_SHEET_SHIFT_DIVY),
+                VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+        }
+        u16fast uCountBest;
+        ActivationLevelType uBelowMin = ActivationLevelType(_getBelowMinFromHistogram<ActivationLevelType>(pFineCounts,
+            pCoarseCounts, uTotalCount, u16fast(_uCurrentWinnerK), uLowestIn, &uCountBest));
+#else
         u16fast uStartX = (uX - uXstartOffset) & VANILLA_HTM_SHEET_XMASK;        // wrapping around 64 X-positions
         u16fast uCountBest = _getBestFromRange<ActivationLevelType, true, false>(uStartX, uXsize, 0u, VANILLA_HTM_SHEET_HEIGHT,
-            pActivationLevelsPerCol, _pTmpTableBest, uTableSize);
+            pActivationLevelsPerCol, scratch._pTmpTableBest, uTableSize);
+        ActivationLevelType uBelowMin = ActivationLevelType(scratch._pTmpTableBest[uCountBest]);
+#endif
         if (uCountBest) {
-            ActivationLevelType uBelowMin = ActivationLevelType(_pTmpTableBest[uCountBest]);
             for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, uIndex++) {
-                if (pActivationLevelsPerCol[uIndex] > uBelowMin)
+                if (pActivationLevelsPerCol[uIndex] > uBelowMin) {
                     vecOutputIndices.push_back(uIndex);
+                    pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+                }
                 if (bOutputMinActivation) { // static test, shall be optimized out when false
                     *pOutputMinActivations = uBelowMin;
                     pOutputMinActivations++;
@@ -1611,11 +3060,76 @@ void VanillaSP::_getActiveColumnsFromActivationLevelsWithLocalInhibAlongX(const
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ActivationLevelType, bool bOutputMinActivation>
-void VanillaSP::_getActiveColumnsFromActivationLevelsWithFullLocalInhib(const ActivationLevelType* pActivationLevelsPerCol,
-    std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations)
+void VanillaSPInferenceCore::_getActiveColumnsFromActivationLevelsWithFullLocalInhib(const ActivationLevelType* pActivationLevelsPerCol,
+    std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+    VanillaSPScratch& scratch) const
 {
     // Full neighborhood computation at each point
-#if (VANILLA_SP_NEIGHBORHOOD_OPTIM == 0)
+#if defined(VANILLA_SP_USE_HISTOGRAM_LOCAL_INHIB) && (VANILLA_SP_NEIGHBORHOOD_OPTIM != VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) && \
+    (VANILLA_SP_NEIGHBORHOOD_OPTIM != VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    // Sliding-window histogram, moving the window in a snake pattern over the sheet (along x, then down one y, then back
+    //   along x...) => each step only removes one strip of (2r+1) levels from the window and adds another
+    u16fast uRadius = u16fast(_uInhibitionRadius);
+    u16fast uSize = 1u + uRadius*2u;
+    uint16* pFineCounts = scratch._pTmpHistogramFineCounts;
+    uint16* pCoarseCounts = scratch._pTmpHistogramCoarseCounts;
+    std::fill(pFineCounts, pFineCounts + (VANILLA_SP_HISTOGRAM_COARSE_COUNT << VANILLA_SP_HISTOGRAM_COARSE_SHIFT), uint16(0u));
+    std::fill(pCoarseCounts, pCoarseCounts + VANILLA_SP_HISTOGRAM_COARSE_COUNT, uint16(0u));
+    u16fast uTotalCount = 0u;
+    uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
+    u16fast uWinnerK = u16fast(_uCurrentWinnerK);
+    uint32* pBelowMinPerCol = scratch._pTmpBelowMinPerCol;  // 0 when no level above threshold in neighborhood
+    for (u16fast uRelX = 0u; uRelX < uSize; uRelX++) {
+        u16fast uCandidateX = (uRelX - uRadius) & VANILLA_HTM_SHEET_XMASK;
+        _updateLevelHistogramWrapped<ActivationLevelType, true>(pActivationLevelsPerCol + (uCandidateX << VANILLA_HTM_SHEET_SHIFT_DIVY),
+            (0u - uRadius) & VANILLA_HTM_SHEET_YMASK, uSize, VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn,
+            pFineCounts, pCoarseCounts, uTotalCount);
+    }
+    u16fast uX = 0u;
+    for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++) {
+        if (uY) {
+            u16fast uStripStartX = (uX - uRadius) & VANILLA_HTM_SHEET_XMASK;
+            u16fast uLeavingY = (uY - uRadius - 1u) & VANILLA_HTM_SHEET_YMASK;
+            u16fast uEnteringY = (uY + uRadius) & VANILLA_HTM_SHEET_YMASK;
+            _updateLevelHistogramWrapped<ActivationLevelType, false>(pActivationLevelsPerCol + uLeavingY, uStripStartX, uSize,
+                VANILLA_HTM_SHEET_WIDTH, VANILLA_HTM_SHEET_HEIGHT, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+            _updateLevelHistogramWrapped<ActivationLevelType, true>(pActivationLevelsPerCol + uEnteringY, uStripStartX, uSize,
+                VANILLA_HTM_SHEET_WIDTH, VANILLA_HTM_SHEET_HEIGHT, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+        }
+        bool bForwardX = (0u == (uY & 1u));
+        u16fast uStripStartY = (uY - uRadius) & VANILLA_HTM_SHEET_YMASK;
+        for (u16fast uStep = 0u; uStep < VANILLA_HTM_SHEET_WIDTH; uStep++) {
+            if (uStep) {
+                u16fast uLeavingX = bForwardX ? (uX - uRadius) : (uX + uRadius);
+                uX = bForwardX ? uX + 1u : uX - 1u;
+                u16fast uEnteringX = bForwardX ? (uX + uRadius) : (uX - uRadius);
+                _updateLevelHistogramWrapped<ActivationLevelType, false>(pActivationLevelsPerCol +
+                    ((uLeavingX & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY), uStripStartY, uSize,
+                    VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+                _updateLevelHistogramWrapped<ActivationLevelType, true>(pActivationLevelsPerCol +
+                    ((uEnteringX & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY), uStripStartY, uSize,
+                    VANILLA_HTM_SHEET_HEIGHT, 1u, uLowestIn, pFineCounts, pCoarseCounts, uTotalCount);
+            }
+            u16fast uCountBest;
+            uint32 uBelowMin = _getBelowMinFromHistogram<ActivationLevelType>(pFineCounts, pCoarseCounts, uTotalCount,
+                uWinnerK, uLowestIn, &uCountBest);
+            pBelowMinPerCol[(uX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uY] = uCountBest ? uBelowMin : 0u;
+        }
+    }
+    // Then selecting in column order, as the other paths do
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+        uint32 uBelowMin = pBelowMinPerCol[uIndex];
+        ActivationLevelType uActivationLevel = pActivationLevelsPerCol[uIndex];
+        if (uActivationLevel > uBelowMin && uActivationLevel > uLowestIn) {
+            vecOutputIndices.push_back(uIndex);
+            pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+        }
+        if (bOutputMinActivation) { // static test, shall be optimized out when false
+            *pOutputMinActivations = uBelowMin;
+            pOutputMinActivations++;
+        }
+    }
+#elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == 0)
     u16fast uIndex = 0u;
     u16fast uStartOffset = size_t(_uInhibitionRadius);
     u16fast uSize = 1u + uStartOffset*2u;
@@ -1625,11 +3139,13 @@ void VanillaSP::_getActiveColumnsFromActivationLevelsWithFullLocalInhib(const Ac
         for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, uIndex++) {
             u16fast uStartY = (uY - uStartOffset) & VANILLA_HTM_SHEET_YMASK;    // wrapping around 32 Y-positions
             u16fast uCountBest = _getBestFromRange<ActivationLevelType, true, true>(uStartX, uSize, uStartY, uSize,
-                pActivationLevelsPerCol, _pTmpTableBest, uTableSize);
+                pActivationLevelsPerCol, scratch._pTmpTableBest, uTableSize);
             if (uCountBest) {
-                ActivationLevelType uBelowMin = ActivationLevelType(_pTmpTableBest[uCountBest]);
-                if (pActivationLevelsPerCol[uIndex] > uBelowMin)
+                ActivationLevelType uBelowMin = ActivationLevelType(scratch._pTmpTableBest[uCountBest]);
+                if (pActivationLevelsPerCol[uIndex] > uBelowMin) {
                     vecOutputIndices.push_back(uIndex);
+                    pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+                }
                 if (bOutputMinActivation) { // static test, shall be optimized out when false
                     *pOutputMinActivations = uBelowMin;
                     pOutputMinActivations++;
@@ -1641,21 +3157,111 @@ void VanillaSP::_getActiveColumnsFromActivationLevelsWithFullLocalInhib(const Ac
         }
     }
 #elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_ALGORITHM)
-    // TODO
-#   error ("_getActiveColumnsFromActivationLevelsWithFullLocalInhib not yet implemented for AlgorithmOpti")
-#elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER)
-    _reduceActivationsByGaussianFilter<ActivationLevelType, bOutputMinActivation>(pActivationLevelsPerCol, pOutputMinActivations);
+    // Same selection as above, but with the k-best lists of all neighborhoods computed by a separable van Herk filter
+    //   => cost per column in O(K) whatever the inhibition radius, instead of O(r^2)
+    u16fast uTableSize = u16fast(_uCurrentWinnerK) + 1u;
+    uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
+    size_t uListsValueCount = size_t(uTableSize) * VANILLA_HTM_SHEET_2DSIZE;
+    scratch._reserveKBestLists(size_t(uTableSize));
+    uint32* pRowMajBestYG = scratch._pTmpKBestLists;
+    uint32* pRowMajBestYRevH = pRowMajBestYG + uListsValueCount;
+    uint32* pColMajBestXG = pRowMajBestYRevH + uListsValueCount;
+    uint32* pColMajBestXRevH = pColMajBestXG + uListsValueCount;
+    _computeOptiForKBestY(pActivationLevelsPerCol, _uInhibitionRadius, pRowMajBestYG, pRowMajBestYRevH, uTableSize, uLowestIn);
+    _computeOptiForKBestX(pRowMajBestYG, pRowMajBestYRevH, _uInhibitionRadius, pColMajBestXG, pColMajBestXRevH,
+        uTableSize, uLowestIn);
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++) {
+        size_t uListOffset = size_t(uIndex) * uTableSize;
+        u16fast uCountBest = _computeKBestFromOpti(pColMajBestXG + uListOffset, pColMajBestXRevH + uListOffset,
+            uTableSize, uLowestIn, scratch._pTmpTableBest);
+        if (uCountBest) {
+            ActivationLevelType uBelowMin = ActivationLevelType(scratch._pTmpTableBest[uCountBest]);
+            if (pActivationLevelsPerCol[uIndex] > uBelowMin) {
+                vecOutputIndices.push_back(uIndex);
+                pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+            }
+            if (bOutputMinActivation) { // static test, shall be optimized out when false
+                *pOutputMinActivations = uBelowMin;
+                pOutputMinActivations++;
+            }
+        } else if (bOutputMinActivation) { // static test, shall be optimized out when false
+            *pOutputMinActivations = 0u;
+            pOutputMinActivations++;
+        }
+    }
+#elif (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_GAUSSFILTER) || \
+    (VANILLA_SP_NEIGHBORHOOD_OPTIM == VANILLA_SP_NEIGHBORHOOD_OPTIM_CONST_BOXGAUSSFILTER)
+    _reduceActivationsByGaussianFilter<ActivationLevelType, bOutputMinActivation>(pActivationLevelsPerCol, pOutputMinActivations,
+        scratch);
 #  if defined(VANILLA_SP_ADD_INVSQDIST_REPULSE)
-    // TODO
-#    error ("_getActiveColumnsFromActivationLevelsWithFullLocalInhib not yet implemented for VANILLA_SP_ADD_INVSQDIST_REPULSE")
+    // greedy selection of the remaining non-zero reduced activations, highest first (lowest index first on ties), each
+    //   rejected if closer than 6.5 to a previous winner. Area around each winner is marked once in an occupancy bitfield
+    //   (one 32b word per x, since sheet is 32 high), so that each test is a single bit lookup. At worst, all 2048 columns
+    //   are candidates, for a sort and a bit test each ; and at most (2048 / 49) winners may mark their area.
+    static_assert(VANILLA_HTM_SHEET_HEIGHT == 32u, "occupancy bitfield expects one 32b word per x");
+    uint64 tCandidates[VANILLA_HTM_SHEET_2DSIZE];
+    u16fast uCandidateCount = 0u;
+    const uint32* pCurrentReduced = scratch._pReducedActivations;
+    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentReduced++) {
+        if (*pCurrentReduced) {
+            tCandidates[uCandidateCount++] = (uint64(*pCurrentReduced) << 11u) | uint64(VANILLA_HTM_SHEET_2DSIZE - 1u - uIndex);
+        }
+    }
+    std::sort(tCandidates, tCandidates + uCandidateCount, std::greater<uint64>());
+    uint32 tOccupiedPerX[VANILLA_HTM_SHEET_WIDTH];
+    std::memset((void*)tOccupiedPerX, 0, sizeof(uint32)*VANILLA_HTM_SHEET_WIDTH);
+    for (u16fast uCandidate = 0u; uCandidate < uCandidateCount; uCandidate++) {
+        uint16 uIndex = uint16(VANILLA_HTM_SHEET_2DSIZE - 1u - (tCandidates[uCandidate] & 0x07FFuLL));
+        u16fast uX = uIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
+        u16fast uY = uIndex & VANILLA_HTM_SHEET_YMASK;
+        if ((tOccupiedPerX[uX] >> uY) & 1u)
+            continue;
+        _markRepulseArea(tOccupiedPerX, uX, uY);
+        vecOutputIndices.push_back(uIndex);
+        pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+    }
+    std::sort(vecOutputIndices.begin(), vecOutputIndices.end());
 #  elif defined(VANILLA_SP_ADD_ONE_7x7)
-    // TODO
-#    error ("_getActiveColumnsFromActivationLevelsWithFullLocalInhib not yet implemented for VANILLA_SP_ADD_KONE_7x7")
+    // single winner over each 7x7 neighborhood, by non-max suppression: separable max filter of the reduced activations (to
+    //   'scratch._pTmpGaussX', gaussian temporaries being free again by now), then keeping those non-zero ones which are
+    //   equal to the max around them.
+    _maxFilter7AlongY(scratch._pReducedActivations, scratch._pTmpGaussY);
+    _maxFilter7AlongX(scratch._pTmpGaussY, scratch._pTmpGaussX, scratch._pTmpGaussX);
+    const uint32* pCurrentReduced = scratch._pReducedActivations;
+    const uint32* pCurrentMax = scratch._pTmpGaussX;
+    for (uint16 uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentReduced++, pCurrentMax++) {
+        bool bIsWinner = *pCurrentReduced && *pCurrentReduced == *pCurrentMax;
+        if (bIsWinner) {
+            // equal maxes within a same 7x7 would all pass the test above => lowest index wins: checking the neighborhood
+            //   for an earlier winner (only ever done for a handful of columns)
+            u16fast uX = uIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
+            u16fast uY = uIndex & VANILLA_HTM_SHEET_YMASK;
+            for (u16fast uRelX = 0u; uRelX < 7u && bIsWinner; uRelX++) {
+                u16fast uStartXIndex = ((uX + uRelX - 3u) & VANILLA_HTM_SHEET_XMASK) << VANILLA_HTM_SHEET_SHIFT_DIVY;
+                for (u16fast uRelY = 0u; uRelY < 7u; uRelY++) {
+                    u16fast uOther = uStartXIndex + ((uY + uRelY - 3u) & VANILLA_HTM_SHEET_YMASK);
+                    if (uOther < uIndex && (pOutputBinaryBitmap[uOther >> 6u] & (1uLL << (uOther & 0x3Fu)))) {
+                        bIsWinner = false;
+                        break;
+                    }
+                }
+            }
+        }
+        if (bIsWinner) {
+            vecOutputIndices.push_back(uIndex);
+            pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+        } else if (bOutputMinActivation) { // static test, shall be optimized out when false
+            // losers would have needed to be at least as high as the best around them, on top of the gaussian reduction
+            pOutputMinActivations[uIndex] += *pCurrentMax;
+        }
+    }
 #  else
-    const uint32* pCurrentReduced = _pReducedActivations;
+    const uint32* pCurrentReduced = scratch._pReducedActivations;
     for (uint16 uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentReduced++) {
-        if (*pCurrentReduced)
+        if (*pCurrentReduced) {
             vecOutputIndices.push_back(uIndex);
+            pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+        }
     }
 #  endif
 #endif
@@ -1728,67 +3334,158 @@ void VanillaSP::_onUpdateOverThresholdRatioTargetWithLocalInhibAlongX() {
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_onUpdateOverThresholdRatioTargetWithFullLocalInhib() {
-    // Full neighborhood computation at each point
-    u16fast uStartOffset = size_t(_uInhibitionRadius);
-    u16fast uSize = size_t(_uInhibitionSideSize);
+    // Full neighborhood computation at each point, as a separable van Herk / Gil-Werman max filter
+    //   => constant cost per column whatever the inhibition radius
+    float* pRowMajMaxYG = _pTmpMaxFilterValues;
+    float* pRowMajMaxYRevH = pRowMajMaxYG + VANILLA_HTM_SHEET_2DSIZE;
+    float* pColMajMaxXG = pRowMajMaxYRevH + VANILLA_HTM_SHEET_2DSIZE;
+    float* pColMajMaxXRevH = pColMajMaxXG + VANILLA_HTM_SHEET_2DSIZE;
+    _computeOptiForMaxY(_pAverageOverThresholdRatioPerColumn, _uInhibitionRadius, pRowMajMaxYG, pRowMajMaxYRevH);
+    _computeOptiForMaxX(pRowMajMaxYG, pRowMajMaxYRevH, _uInhibitionRadius, pColMajMaxXG, pColMajMaxXRevH);
     float *pCurrentTarget = _pOverThresholdRatioTargetPerColumn;
-    for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-        u16fast uStartX = (uX - uStartOffset) & VANILLA_HTM_SHEET_XMASK;        // wrapping around 64 X-positions
-        for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, pCurrentTarget++) {
-            u16fast uStartY = (uY - uStartOffset) & VANILLA_HTM_SHEET_YMASK;        // wrapping around 32 Y-positions
-            float fMaxOverlapDutyCycles = _getMaxFromRange<true, true>(uStartX, uSize, uStartY, uSize,
-                _pAverageOverThresholdRatioPerColumn);
-            float fTargetThere = fMaxOverlapDutyCycles * _fOverThresholdTargetVsMaxRatio;
-            *pCurrentTarget = fTargetThere;
-        }
+    for (u16fast uCol = 0u; uCol < VANILLA_HTM_SHEET_2DSIZE; uCol++, pCurrentTarget++) {
+        float fMaxOverlapDutyCycles = _computeMaxFromOpti(pColMajMaxXG + uCol, pColMajMaxXRevH + uCol);
+        float fTargetThere = fMaxOverlapDutyCycles * _fOverThresholdTargetVsMaxRatio;
+        *pCurrentTarget = fTargetThere;
     }
 }
 
 #  else // Hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKETS
 
 // - - - - - - - - - - - - - - - - - - - -
+// Returns the (col-major) index of the first column of a bucket, buckets being numbered along y first
+//   (a column of buckets spanning the whole sheet height, 'uBucket * uBucketSize' has bucket x in its high bits)
 // - - - - - - - - - - - - - - - - - - - -
-template<typename ActivationLevelType, bool bOutputMinActivation>
-void VanillaSP::_getActiveColumnsFromActivationLevelsWithBucketInhib(const ActivationLevelType* pActivationLevelsPerCol,
-    std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations)
+FORCE_INLINE static u16fast _getBucketStartIndex(u16fast uBucket, u16fast uBucketSize) FORCE_INLINE_END
 {
-    // TODO : if pOutputMinActivations
+    u16fast uScaled = uBucket * uBucketSize;
+    u16fast uStartX = (uScaled >> VANILLA_HTM_SHEET_SHIFT_DIVY) * uBucketSize;
+    u16fast uStartY = uScaled & VANILLA_HTM_SHEET_YMASK;
+    return (uStartX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uStartY;
+}
 
+// - - - - - - - - - - - - - - - - - - - -
+// Dispatches to the 'maskAbove' kernel matching either Raw (16b) or Boosted (32b) 'ActivationLevel' values
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE static uint32 _getMaskAbove(const uint16* pValues, size_t uCount, uint32 uThreshold,
+    MaskAbove16Func pMaskAbove16Func, MaskAbove32Func pMaskAbove32Func) FORCE_INLINE_END
+{
+    HTMATCH_unused(pMaskAbove32Func);
+    return pMaskAbove16Func(pValues, uCount, uint16(uThreshold));
+}
+FORCE_INLINE static uint32 _getMaskAbove(const uint32* pValues, size_t uCount, uint32 uThreshold,
+    MaskAbove16Func pMaskAbove16Func, MaskAbove32Func pMaskAbove32Func) FORCE_INLINE_END
+{
+    HTMATCH_unused(pMaskAbove16Func);
+    return pMaskAbove32Func(pValues, uCount, uThreshold);
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// Same selection as _getBestFromRange() over the bucket, followed by emission of the levels above the value to beat ; but
+//   whenever the runs of the bucket along y are at least one 256b vector long, each of them is first compared as a whole
+//   against the current tail of the queue by a 'maskAbove' kernel, so that only the (few) levels found above it are then
+//   visited one by one. Shorter runs are visited level by level, as the kernel could not do better for them.
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType, bool bOutputMinActivation>
+u16fast VanillaSPInferenceCore::_getWinnersInBucket(u16fast uBucket, const ActivationLevelType* pActivationLevelsPerCol,
+    uint16* pOutWinners, uint32* pOutputMinActivations) const
+{
     u16fast uBucketSize = u16fast(_uBucketSize);
-    u16fast uBucketCountY = u16fast(_uBucketCountY);
-    u16fast uBucketCountX = uBucketCountY << (VANILLA_HTM_SHEET_SHIFT_DIVX - VANILLA_HTM_SHEET_SHIFT_DIVY);
-    u16fast uTableSize = u16fast(_uCurrentWinnerK) + 1u;
-    u16fast uStartX = 0u;
-    for (u16fast uBucketX = 0u; uBucketX < uBucketCountX; uBucketX++, uStartX += uBucketSize) {
-        u16fast uStartY = 0u;
-        for (u16fast uBucketY = 0u; uBucketY < uBucketCountY; uBucketY++, uStartY += uBucketSize) {
-            u16fast uCountBest = _getBestFromRange<ActivationLevelType, false, false>(
-                uStartX, uBucketSize, uStartY, uBucketSize,
-                pActivationLevelsPerCol, _pTmpTableBest, uTableSize);
-            if (uCountBest) {
-                ActivationLevelType uBelowMin = ActivationLevelType(_pTmpTableBest[uCountBest]);
-                u16fast uStartIndex = (uStartX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uStartY;
-                for (u16fast uX = uStartX, uEndX = uStartX + uBucketSize; uX < uEndX; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
-                    u16fast uIndex = uint16(uStartIndex);
-                    for (u16fast uY = uStartY, uEndY = uStartY + uBucketSize; uY < uEndY; uY++, uIndex++) {
-                        if (pActivationLevelsPerCol[uIndex] > uBelowMin)
-                            vecOutputIndices.push_back(uIndex);
-                        if (bOutputMinActivation) // static test, shall be optimized out when false
-                            pOutputMinActivations[uIndex] = uBelowMin;
-                    }
+    u16fast uStartIndex = _getBucketStartIndex(uBucket, uBucketSize);
+    bool bMaskedRuns = (uBucketSize * sizeof(ActivationLevelType)) >= 32u;
+    uint32 tQueueOfBestValues[VANILLA_SP_MAX_WINNERS + 1u];     // own queue => no sharing between buckets
+    u16fast uQueueCapacity = u16fast(_uCurrentWinnerK) + 1u;
+    u16fast uCountBest;
+    if (bMaskedRuns) {
+        uint32 uLowestIn = _getBelowStimulusThreshold<ActivationLevelType>();
+        tQueueOfBestValues[0] = uLowestIn;
+        u16fast uQueueSize = 1u;
+        const ActivationLevelType* pRun = pActivationLevelsPerCol + uStartIndex;
+        for (u16fast uX = 0u; uX < uBucketSize; uX++, pRun += VANILLA_HTM_SHEET_HEIGHT) {
+            uint32 uMaskAbove = _getMaskAbove(pRun, uBucketSize, uLowestIn, _pMaskAbove16Func, _pMaskAbove32Func);
+            while (uMaskAbove) {
+                uint32 uActivationLevel = uint32(pRun[getTrailingZeroesCount32(uMaskAbove)]);
+                if (uActivationLevel > uLowestIn) { // tail may have risen since the run was compared
+                    uQueueSize = _insertInQueueOfBest(tQueueOfBestValues, uActivationLevel, uQueueCapacity, uQueueSize,
+                        &uLowestIn);
                 }
+                uMaskAbove &= uMaskAbove - 1u;
             }
-            else if (bOutputMinActivation) { // static test, shall be optimized out when false
-                u16fast uStartIndex = (uStartX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uStartY;
-                for (u16fast uX = uStartX, uEndX = uStartX + uBucketSize; uX < uEndX; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
-                    u16fast uIndex = uint16(uStartIndex);
-                    for (u16fast uY = uStartY, uEndY = uStartY + uBucketSize; uY < uEndY; uY++, uIndex++) {
-                        pOutputMinActivations[uIndex] = 0u;
-                    }
+        }
+        uCountBest = uQueueSize - 1u;
+    } else {
+        uCountBest = _getBestFromRange<ActivationLevelType, false, false>(uStartIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY,
+            uBucketSize, uStartIndex & VANILLA_HTM_SHEET_YMASK, uBucketSize, pActivationLevelsPerCol, tQueueOfBestValues,
+            uQueueCapacity);
+    }
+    u16fast uWinnerCount = 0u;
+    uint32 uBelowMin = 0u;
+    if (uCountBest) {
+        uBelowMin = uint32(ActivationLevelType(tQueueOfBestValues[uCountBest]));
+        const ActivationLevelType* pRun = pActivationLevelsPerCol + uStartIndex;
+        u16fast uRunStartIndex = uStartIndex;
+        for (u16fast uX = 0u; uX < uBucketSize; uX++, pRun += VANILLA_HTM_SHEET_HEIGHT,
+                uRunStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
+            if (bMaskedRuns) {
+                uint32 uMaskAbove = _getMaskAbove(pRun, uBucketSize, uBelowMin, _pMaskAbove16Func, _pMaskAbove32Func);
+                while (uMaskAbove) {
+                    pOutWinners[uWinnerCount++] = uint16(uRunStartIndex + getTrailingZeroesCount32(uMaskAbove));
+                    uMaskAbove &= uMaskAbove - 1u;
+                }
+            } else {
+                for (u16fast uY = 0u; uY < uBucketSize; uY++) {
+                    if (uint32(pRun[uY]) > uBelowMin)
+                        pOutWinners[uWinnerCount++] = uint16(uRunStartIndex + uY);
                 }
             }
         }
     }
+    if (bOutputMinActivation) { // static test, shall be optimized out when false
+        uint32* pCurrentMin = pOutputMinActivations + uStartIndex;
+        for (u16fast uX = 0u; uX < uBucketSize; uX++, pCurrentMin += VANILLA_HTM_SHEET_HEIGHT) {
+            std::fill(pCurrentMin, pCurrentMin + uBucketSize, uBelowMin);
+        }
+    }
+    return uWinnerCount;
+}
+; // template termination
+
+// - - - - - - - - - - - - - - - - - - - -
+// Buckets do not overlap => each one gets selected on its own (in parallel, if parallel mode is on), to its slot of
+//   '_pTmpBucketWinners', and those slots are then gathered in bucket order, giving the same output as a sequential visit.
+// - - - - - - - - - - - - - - - - - - - -
+template<typename ActivationLevelType, bool bOutputMinActivation>
+void VanillaSPInferenceCore::_getActiveColumnsFromActivationLevelsWithBucketInhib(const ActivationLevelType* pActivationLevelsPerCol,
+    std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+    VanillaSPScratch& scratch) const
+{
+    u16fast uBucketSize = u16fast(_uBucketSize);
+    u16fast uSlotSize = uBucketSize * uBucketSize;
+    u16fast uBucketCount = VANILLA_HTM_SHEET_2DSIZE / uSlotSize;
+    uint16* pBucketWinners = scratch._pTmpBucketWinners;
+    uint16* pBucketWinnerCounts = scratch._pTmpBucketWinnerCounts;
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        HTMATCH::for_count(HTMATCH_PAR, 0u, uBucketCount,
+                [this, pActivationLevelsPerCol, pBucketWinners, pBucketWinnerCounts, uSlotSize, pOutputMinActivations](u32fast uBucket) {
+            pBucketWinnerCounts[uBucket] = uint16(_getWinnersInBucket<ActivationLevelType, bOutputMinActivation>(
+                u16fast(uBucket), pActivationLevelsPerCol, pBucketWinners + uBucket * uSlotSize, pOutputMinActivations));
+        });
+    } else
+#endif
+    for (u16fast uBucket = 0u; uBucket < uBucketCount; uBucket++) {
+        pBucketWinnerCounts[uBucket] = uint16(_getWinnersInBucket<ActivationLevelType, bOutputMinActivation>(
+            uBucket, pActivationLevelsPerCol, pBucketWinners + uBucket * uSlotSize, pOutputMinActivations));
+    }
+    const uint16* pCurrentSlot = pBucketWinners;
+    for (u16fast uBucket = 0u; uBucket < uBucketCount; uBucket++, pCurrentSlot += uSlotSize) {
+        for (const uint16 *pCurrent = pCurrentSlot, *pEnd = pCurrentSlot + pBucketWinnerCounts[uBucket]; pCurrent < pEnd;
+                pCurrent++) {
+            u16fast uIndex = *pCurrent;
+            vecOutputIndices.push_back(uint16(uIndex));
+            pOutputBinaryBitmap[uIndex >> 6u] |= (1uLL << (uIndex & 0x3Fu));
+        }
+    }
 }
 ; // template termination
 
@@ -1798,26 +3495,29 @@ void VanillaSP::_getActiveColumnsFromActivationLevelsWithBucketInhib(const Activ
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_onEvaluateBoostingFromColumnUsageWithBucketInhib() {
     u16fast uBucketSize = u16fast(_uBucketSize);
-    u16fast uBucketCountY = u16fast(_uBucketCountY);
-    u16fast uBucketCountX = uBucketCountY << (VANILLA_HTM_SHEET_SHIFT_DIVX - VANILLA_HTM_SHEET_SHIFT_DIVY);
+    u16fast uBucketCount = VANILLA_HTM_SHEET_2DSIZE / (uBucketSize * uBucketSize);
     float fInvNumNeighbors = 1.0f / float(_uBucketSize * _uBucketSize);
-    u16fast uStartX = 0u;
-    for (u16fast uBucketX = 0u; uBucketX < uBucketCountX; uBucketX++, uStartX += uBucketSize) {
-        u16fast uStartY = 0u;
-        for (u16fast uBucketY = 0u; uBucketY < uBucketCountY; uBucketY++, uStartY += uBucketSize) {
-            float fLocalActivityAverage = _getSumFromRange<false, false>(uStartX, uBucketSize, uStartY, uBucketSize,
-                _pAverageActiveRatioPerColumn) * fInvNumNeighbors;
-            u16fast uStartIndex = (uStartX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uStartY;
-            for (u16fast uX = uStartX, uEndX = uStartX + uBucketSize; uX < uEndX; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
-                uint16* pCurrentBoosting = _pBoostingPerCol + uStartIndex;
-                const float* pCurrentActivRatio = _pAverageActiveRatioPerColumn + uStartIndex;
-                for (u16fast uY = uStartY, uEndY = uStartY + uBucketSize; uY < uEndY;
-                        uY++, pCurrentBoosting++, pCurrentActivRatio++) {
-                    *pCurrentBoosting = _getBoostFactorUint16(fLocalActivityAverage, *pCurrentActivRatio);
-                    //*pCurrentBoosting = _getBoostFactorUint16(_fActivationDensityRatio, *pCurrentActivRatio);
-                }
+    auto evaluateBucket = [this, uBucketSize, fInvNumNeighbors](u32fast uBucket) {
+        u16fast uStartIndex = _getBucketStartIndex(u16fast(uBucket), uBucketSize);
+        float fLocalActivityAverage = _getSumFromRange<false, false>(uStartIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY, uBucketSize,
+            uStartIndex & VANILLA_HTM_SHEET_YMASK, uBucketSize, _pAverageActiveRatioPerColumn) * fInvNumNeighbors;
+        for (u16fast uX = 0u; uX < uBucketSize; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
+            uint16* pCurrentBoosting = _pBoostingPerCol + uStartIndex;
+            const float* pCurrentActivRatio = _pAverageActiveRatioPerColumn + uStartIndex;
+            for (u16fast uY = 0u; uY < uBucketSize; uY++, pCurrentBoosting++, pCurrentActivRatio++) {
+                *pCurrentBoosting = _getBoostFactorUint16(fLocalActivityAverage, *pCurrentActivRatio);
+                //*pCurrentBoosting = _getBoostFactorUint16(_fActivationDensityRatio, *pCurrentActivRatio);
             }
         }
+    };
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        HTMATCH::for_count(HTMATCH_PAR, 0u, uBucketCount, evaluateBucket);
+        return;
+    }
+#endif
+    for (u16fast uBucket = 0u; uBucket < uBucketCount; uBucket++) {
+        evaluateBucket(uBucket);
     }
 }
 
@@ -1827,23 +3527,25 @@ void VanillaSP::_onEvaluateBoostingFromColumnUsageWithBucketInhib() {
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_onUpdateOverThresholdRatioTargetWithBucketInhib() {
     u16fast uBucketSize = u16fast(_uBucketSize);
-    u16fast uBucketCountY = u16fast(_uBucketCountY);
-    u16fast uBucketCountX = uBucketCountY << (VANILLA_HTM_SHEET_SHIFT_DIVX - VANILLA_HTM_SHEET_SHIFT_DIVY);
-    u16fast uStartX = 0u;
-    for (u16fast uBucketX = 0u; uBucketX < uBucketCountX; uBucketX++, uStartX += uBucketSize) {
-        u16fast uStartY = 0u;
-        for (u16fast uBucketY = 0u; uBucketY < uBucketCountY; uBucketY++, uStartY += uBucketSize) {
-            float fMaxAmongNeighbors = _getMaxFromRange<false, false>(uStartX, uBucketSize, uStartY, uBucketSize,
-                _pAverageOverThresholdRatioPerColumn);
-            float fTargetThere = fMaxAmongNeighbors * _fOverThresholdTargetVsMaxRatio;
-            u16fast uStartIndex = (uStartX << VANILLA_HTM_SHEET_SHIFT_DIVY) + uStartY;
-            for (u16fast uX = uStartX, uEndX = uStartX + uBucketSize; uX < uEndX; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
-                float *pCurrentTarget = _pOverThresholdRatioTargetPerColumn + uStartIndex;
-                for (u16fast uY = uStartY, uEndY = uStartY + uBucketSize; uY < uEndY; uY++, pCurrentTarget++) {
-                    *pCurrentTarget = fTargetThere;
-                }
-            }
+    u16fast uBucketCount = VANILLA_HTM_SHEET_2DSIZE / (uBucketSize * uBucketSize);
+    auto updateBucket = [this, uBucketSize](u32fast uBucket) {
+        u16fast uStartIndex = _getBucketStartIndex(u16fast(uBucket), uBucketSize);
+        float fMaxAmongNeighbors = _getMaxFromRange<false, false>(uStartIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY, uBucketSize,
+            uStartIndex & VANILLA_HTM_SHEET_YMASK, uBucketSize, _pAverageOverThresholdRatioPerColumn);
+        float fTargetThere = fMaxAmongNeighbors * _fOverThresholdTargetVsMaxRatio;
+        for (u16fast uX = 0u; uX < uBucketSize; uX++, uStartIndex += VANILLA_HTM_SHEET_HEIGHT) {
+            float *pCurrentTarget = _pOverThresholdRatioTargetPerColumn + uStartIndex;
+            std::fill(pCurrentTarget, pCurrentTarget + uBucketSize, fTargetThere);
         }
+    };
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        HTMATCH::for_count(HTMATCH_PAR, 0u, uBucketCount, updateBucket);
+        return;
+    }
+#endif
+    for (u16fast uBucket = 0u; uBucket < uBucketCount; uBucket++) {
+        updateBucket(uBucket);
     }
 }
 
@@ -1854,22 +3556,26 @@ void VanillaSP::_onUpdateOverThresholdRatioTargetWithBucketInhib() {
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ActivationLevelType, bool bOutputMinActivation>
-void VanillaSP::_getActiveColumnsFromActivationLevelsWithGlobalInhib(const ActivationLevelType* pActivationLevelsPerCol,
-    std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations)
+void VanillaSPInferenceCore::_getActiveColumnsFromActivationLevelsWithGlobalInhib(const ActivationLevelType* pActivationLevelsPerCol,
+    std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+    VanillaSPScratch& scratch) const
 {
-    u16fast uCountBest = _getBestFromRange<ActivationLevelType, false, false>(
-        0u, VANILLA_HTM_SHEET_WIDTH, 0u, VANILLA_HTM_SHEET_HEIGHT,
-        pActivationLevelsPerCol, _pTmpTableBest, u16fast(_uCurrentWinnerK)+1u);
+    uint32 uBelowMin;
+    u16fast uCountBest = _getBestThresholdFromWholeSheet(pActivationLevelsPerCol, u16fast(_uCurrentWinnerK),
+        scratch._pTmpRadixSelectCounts, scratch._pTmpRadixSelectCandidates, &uBelowMin);
     if (uCountBest) {
-        ActivationLevelType uBelowMin = ActivationLevelType(_pTmpTableBest[uCountBest]);
-        u16fast uIndex = 0u;
-        const ActivationLevelType* pCurrentActivationLevel = pActivationLevelsPerCol;
-        for (u16fast uX = 0u; uX < VANILLA_HTM_SHEET_WIDTH; uX++) {
-            for (u16fast uY = 0u; uY < VANILLA_HTM_SHEET_HEIGHT; uY++, uIndex++, pCurrentActivationLevel++) {
-                if (*pCurrentActivationLevel > uBelowMin)
-                    vecOutputIndices.push_back(uIndex);
-            }
+        // at most 'uCountBest' levels are above 'uBelowMin' (fewer on ties) => single compare-and-compress sweep to emit them
+        size_t uPreviousSize = vecOutputIndices.size();
+        vecOutputIndices.resize(uPreviousSize + uCountBest);
+        size_t uEmitted;
+        if (sizeof(ActivationLevelType) == 4u) {    // boosted (static test)
+            uEmitted = _pCompressIndicesAbove32Func(reinterpret_cast<const uint32*>(pActivationLevelsPerCol),
+                VANILLA_HTM_SHEET_2DSIZE, uBelowMin, vecOutputIndices.data() + uPreviousSize, pOutputBinaryBitmap);
+        } else {
+            uEmitted = _pCompressIndicesAbove16Func(reinterpret_cast<const uint16*>(pActivationLevelsPerCol),
+                VANILLA_HTM_SHEET_2DSIZE, uint16(uBelowMin), vecOutputIndices.data() + uPreviousSize, pOutputBinaryBitmap);
         }
+        vecOutputIndices.resize(uPreviousSize + uEmitted);
         if (bOutputMinActivation) { // static test, shall be optimized out when false
             for (uint32* pCurrentOutputMin = pOutputMinActivations, *pEnd = pOutputMinActivations + VANILLA_HTM_SHEET_2DSIZE;
                 pCurrentOutputMin < pEnd; pCurrentOutputMin++) {
@@ -1902,272 +3608,605 @@ void VanillaSP::_onUpdateOverThresholdRatioTargetWithGlobalInhib()
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 template<typename ActivationLevelType>
-void VanillaSP::_getActiveColumnsFromActivationLevels(const ActivationLevelType* pActivationLevelsPerCol,
-    std::vector<uint16>& vecOutputIndices, uint32* pOutputMinActivations)
+void VanillaSPInferenceCore::_getActiveColumnsFromActivationLevels(const ActivationLevelType* pActivationLevelsPerCol,
+    std::vector<uint16>& vecOutputIndices, uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations,
+    VanillaSPScratch& scratch) const
 {
+    // winners set their own bit in the output bitfield as soon as they get selected => start from a cleared one
+    memset((void*)pOutputBinaryBitmap, 0, VANILLA_HTM_SHEET_BYTES_BINARY);
 #if defined(VANILLA_SP_USE_LOCAL_INHIB)
 #  if (VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_NOMINAL)
     if (_uInhibitionSideSize < VANILLA_SP_MIN_AREA_SIDE_SIZE || _uInhibitionSideSize >= VANILLA_HTM_SHEET_WIDTH) {
         if (pOutputMinActivations)
             _getActiveColumnsFromActivationLevelsWithGlobalInhib<ActivationLevelType, true>(pActivationLevelsPerCol,
-                vecOutputIndices, pOutputMinActivations);
+                vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations, scratch);
         else
             _getActiveColumnsFromActivationLevelsWithGlobalInhib<ActivationLevelType, false>(pActivationLevelsPerCol,
-                vecOutputIndices, 0);
+                vecOutputIndices, pOutputBinaryBitmap, 0, scratch);
     } else if (_uInhibitionSideSize >= VANILLA_HTM_SHEET_HEIGHT) {
         if (pOutputMinActivations)
             _getActiveColumnsFromActivationLevelsWithLocalInhibAlongX<ActivationLevelType, true>(pActivationLevelsPerCol,
-                vecOutputIndices, pOutputMinActivations);
+                vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations, scratch);
         else
             _getActiveColumnsFromActivationLevelsWithLocalInhibAlongX<ActivationLevelType, false>(pActivationLevelsPerCol,
-                vecOutputIndices, 0);
+                vecOutputIndices, pOutputBinaryBitmap, 0, scratch);
     } else {
         if (pOutputMinActivations)
             _getActiveColumnsFromActivationLevelsWithFullLocalInhib<ActivationLevelType, true>(pActivationLevelsPerCol,
-                vecOutputIndices, pOutputMinActivations);
+                vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations, scratch);
         else
             _getActiveColumnsFromActivationLevelsWithFullLocalInhib<ActivationLevelType, false>(pActivationLevelsPerCol,
-                vecOutputIndices, 0);
+                vecOutputIndices, pOutputBinaryBitmap, 0, scratch);
     }
 #  else // hopefully VANILLA_SP_USE_LOCAL_INHIB == VANILLA_SP_LOCAL_INHIB_TYPE_BUCKET
     if (pOutputMinActivations)
         _getActiveColumnsFromActivationLevelsWithBucketInhib<ActivationLevelType, true>(pActivationLevelsPerCol,
-            vecOutputIndices, pOutputMinActivations);
+            vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations, scratch);
     else
         _getActiveColumnsFromActivationLevelsWithBucketInhib<ActivationLevelType, false>(pActivationLevelsPerCol,
-            vecOutputIndices, 0);
+            vecOutputIndices, pOutputBinaryBitmap, 0, scratch);
 #  endif
 #else   // Global inhib
     if (pOutputMinActivations)
         _getActiveColumnsFromActivationLevelsWithGlobalInhib<ActivationLevelType, true>(pActivationLevelsPerCol,
-            vecOutputIndices, pOutputMinActivations);
+            vecOutputIndices, pOutputBinaryBitmap, pOutputMinActivations, scratch);
     else
         _getActiveColumnsFromActivationLevelsWithGlobalInhib<ActivationLevelType, false>(pActivationLevelsPerCol,
-            vecOutputIndices, 0);
+            vecOutputIndices, pOutputBinaryBitmap, 0, scratch);
 #endif
 }
 ; // template termination
 
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE void VanillaSP::_addToInvertedIndex(u16fast uColumnIndex, u16fast uPreSynCellIndex) FORCE_INLINE_END
+{
+    _bStreamingStateValid = false;      // connectivity changed => no incremental update of activation levels on next round
+    uint32 uStart = _pInvertedIndexStartPerCell[uPreSynCellIndex];
+    uint16& uCountRef = _pInvertedIndexCountPerCell[uPreSynCellIndex];
+    // capacity check shall always pass... except if rerolls changed potential pools since last rebuild
+    if (uStart + uCountRef < _pInvertedIndexStartPerCell[uPreSynCellIndex + 1u]) {
+        _pInvertedIndexColumns[uStart + uCountRef] = uint16(uColumnIndex);
+        uCountRef++;
+        _uInvertedIndexTotalCount++;
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE void VanillaSP::_removeFromInvertedIndex(u16fast uColumnIndex, u16fast uPreSynCellIndex) FORCE_INLINE_END
+{
+    _bStreamingStateValid = false;      // connectivity changed => no incremental update of activation levels on next round
+    uint16* pCurrentCol = _pInvertedIndexColumns + _pInvertedIndexStartPerCell[uPreSynCellIndex];
+    uint16& uCountRef = _pInvertedIndexCountPerCell[uPreSynCellIndex];
+    for (uint16* pEndCol = pCurrentCol + uCountRef; pCurrentCol < pEndCol; pCurrentCol++) {
+        if (*pCurrentCol == uColumnIndex) {
+            *pCurrentCol = *(pEndCol - 1);  // order within a list is irrelevant => swap with last
+            uCountRef--;
+            _uInvertedIndexTotalCount--;
+            break;
+        }
+    }
+}
+
+#endif // VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE void VanillaSP::_connectSynapseInField(uint64* pConnectivityField, u16fast uColumnIndex,
+    u16fast uPreSynCellIndex, uint32** ppDeferredIndexUpdates) FORCE_INLINE_END
+{
+    size_t uPreSynCellQword = _getConnectivityFieldQwordPos(uColumnIndex, uPreSynCellIndex);
+    uint64 uPreSynCellMask = 1uLL << (uPreSynCellIndex & 0x003Fu);
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // the inverted index mirrors connectivity bits, not synapses (in case several synapses would target the same cell)
+    if (0uLL == (pConnectivityField[uPreSynCellQword] & uPreSynCellMask)) {
+        if (ppDeferredIndexUpdates) {
+            *((*ppDeferredIndexUpdates)++) = (uint32(uPreSynCellIndex) << 1u) | 1u;   // lsb set => connection
+        } else {
+            _addToInvertedIndex(uColumnIndex, uPreSynCellIndex);
+        }
+    }
+#else
+    HTMATCH_unused(ppDeferredIndexUpdates);
+#endif
+    pConnectivityField[uPreSynCellQword] |= uPreSynCellMask;
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+FORCE_INLINE void VanillaSP::_disconnectSynapseInField(uint64* pConnectivityField, u16fast uColumnIndex,
+    u16fast uPreSynCellIndex, uint32** ppDeferredIndexUpdates) FORCE_INLINE_END
+{
+    size_t uPreSynCellQword = _getConnectivityFieldQwordPos(uColumnIndex, uPreSynCellIndex);
+    uint64 uPreSynCellMask = 1uLL << (uPreSynCellIndex & 0x003Fu);
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    if (pConnectivityField[uPreSynCellQword] & uPreSynCellMask) {
+        if (ppDeferredIndexUpdates) {
+            *((*ppDeferredIndexUpdates)++) = uint32(uPreSynCellIndex) << 1u;          // lsb clear => disconnection
+        } else {
+            _removeFromInvertedIndex(uColumnIndex, uPreSynCellIndex);
+        }
+    }
+#else
+    HTMATCH_unused(ppDeferredIndexUpdates);
+#endif
+    pConnectivityField[uPreSynCellQword] &= ~uPreSynCellMask;
+}
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_updateSynapsesOnActiveColumnsTowardsCurrentInput(const uint64* pInputBinaryBitmap,
     const std::vector<uint16>& vecActiveIndices)
 {
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        _updateSynapsesOnActiveColumnsInParallel(pInputBinaryBitmap, vecActiveIndices);
+        return;
+    }
+#endif
     for (auto itActive = vecActiveIndices.begin(), itEndActive = vecActiveIndices.end(); itActive != itEndActive; itActive++) {
-        uint16 uActiveIndex = *itActive;
-        Segment& currentSeg = _pSegments[uActiveIndex];
+        _updateSynapsesOnColumnTowardsCurrentInput(pInputBinaryBitmap, *itActive, 0);
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_updateSynapsesOnColumnTowardsCurrentInput(const uint64* pInputBinaryBitmap, u16fast uColumnIndex,
+    uint32** ppDeferredIndexUpdates)
+{
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    // Bit-sliced permanences: no per-synapse lookup of the input, we rather add or subtract across 64 synapses at a time
+    _updatePermanencePlanes(pInputBinaryBitmap, uColumnIndex, VANILLA_SP_SYN_PERM_ACTIVE_INC,
+        VANILLA_SP_SYN_PERM_INACTIVE_DEC, ppDeferredIndexUpdates);
+#else
+    Segment& currentSeg = _pSegments[uColumnIndex];
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-        uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uActiveIndex;
+    uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uColumnIndex;
+#else
+    HTMATCH_unused(ppDeferredIndexUpdates);
 #endif
-        u16fast uCount = currentSeg._uCount;
-        uint16* pPreSyn = currentSeg._tPreSynIndex;
-        VANILLA_SP_SYN_PERM_TYPE* pPerm = currentSeg._tPermValue;
-        for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
-            u16fast uPreSynCellIndex = *pPreSyn;
-            u16fast uPreSynCellQword = uPreSynCellIndex >> 6u;
-            u16fast uPreSynCellBit = uPreSynCellIndex & 0x003Fu;
-            VANILLA_SP_SYN_PERM_TYPE permanenceValue = *pPerm;
-            uint64 uPreSynCellValue = (pInputBinaryBitmap[uPreSynCellQword] >> uPreSynCellBit) & 1uLL;
+    u16fast uCount = currentSeg._uCount;
+    uint16* pPreSyn = currentSeg._tPreSynIndex;
+    VANILLA_SP_SYN_PERM_TYPE* pPerm = currentSeg._tPermValue;
+#if defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI) && (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
+    // Fixed-point permanences: all of them updated at once by the (vectorized) learning kernel, which reports which
+    //   synapses crossed the connection threshold. Those are then handled in ascending synapse order, as the scalar loop
+    //   would have, so that deferred index updates are recorded in the exact same order.
+    uint64 tCrossings[(VANILLA_SP_MAX_SYNAPSES_PER_SEG + 63u) >> 6u];
+    _pUpdatePermanencesFunc(pPreSyn, pPerm, uCount, pInputBinaryBitmap, VANILLA_SP_SYN_PERM_ACTIVE_INC,
+        VANILLA_SP_SYN_PERM_INACTIVE_DEC, VANILLA_SP_SYN_CONNECTED_PERM, tCrossings);
+    u16fast uCrossingsQwords = (uCount + 63u) >> 6u;
+    for (u16fast uQword = 0u; uQword < uCrossingsQwords; uQword++) {
+        uint64 uCrossings = tCrossings[uQword];
+        while (uCrossings) {
+            u16fast uSyn = (uQword << 6u) + u16fast(getTrailingZeroesCount64(uCrossings));
+            uCrossings &= uCrossings - 1uLL;
+            if (pPerm[uSyn] >= VANILLA_SP_SYN_CONNECTED_PERM) {
+                _connectSynapseInField(pCurrentConnectivityField, uColumnIndex, pPreSyn[uSyn], ppDeferredIndexUpdates);
+            } else {
+                _disconnectSynapseInField(pCurrentConnectivityField, uColumnIndex, pPreSyn[uSyn], ppDeferredIndexUpdates);
+            }
+        }
+    }
+#else
+    for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
+        u16fast uPreSynCellIndex = *pPreSyn;
+        u16fast uPreSynCellQword = uPreSynCellIndex >> 6u;
+        u16fast uPreSynCellBit = uPreSynCellIndex & 0x003Fu;
+        VANILLA_SP_SYN_PERM_TYPE permanenceValue = *pPerm;
+        uint64 uPreSynCellValue = (pInputBinaryBitmap[uPreSynCellQword] >> uPreSynCellBit) & 1uLL;
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-            // If we're using connectivity field optimization,
-            //   then we need to update here the connectivity bitfield whenever a synapse connection status changes as
-            //   a result of the changes to its permanence value.
-            if (uPreSynCellValue) {
-                if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
-                    permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_ACTIVE_INC);
-                    if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
-                        uint64 uPreSynCellMask = 1uLL << uPreSynCellBit;
-                        pCurrentConnectivityField[uPreSynCellQword] |= uPreSynCellMask;
-                    }
-                } else {
-                    permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_ACTIVE_INC);
+        // If we're using connectivity field optimization,
+        //   then we need to update here the connectivity bitfield whenever a synapse connection status changes as
+        //   a result of the changes to its permanence value.
+        if (uPreSynCellValue) {
+            if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
+                permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_ACTIVE_INC);
+                if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
+                    _connectSynapseInField(pCurrentConnectivityField, uColumnIndex, uPreSynCellIndex,
+                        ppDeferredIndexUpdates);
                 }
             } else {
-                if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
-                    permanenceValue = _decreasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_INACTIVE_DEC);
-                    if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
-                        uint64 uPreSynCellMask = ~(1uLL << uPreSynCellBit);
-                        pCurrentConnectivityField[uPreSynCellQword] &= uPreSynCellMask;
-                    }
-                } else {
-                    permanenceValue = _decreasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_INACTIVE_DEC);
+                permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_ACTIVE_INC);
+            }
+        } else {
+            if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
+                permanenceValue = _decreasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_INACTIVE_DEC);
+                if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
+                    _disconnectSynapseInField(pCurrentConnectivityField, uColumnIndex, uPreSynCellIndex,
+                        ppDeferredIndexUpdates);
                 }
+            } else {
+                permanenceValue = _decreasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_INACTIVE_DEC);
             }
-            *pPerm = permanenceValue;
+        }
+        *pPerm = permanenceValue;
 #else // !VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-            VANILLA_SP_SYN_SIGNED_PERM_TYPE ifPreSynActive = VANILLA_SP_SYN_SIGNED_PERM_TYPE(uPreSynCellValue);
-            VANILLA_SP_SYN_SIGNED_PERM_TYPE ifPreSynSilent = VANILLA_SP_SYN_SIGNED_PERM_TYPE(1) - ifPreSynActive;
-            VANILLA_SP_SYN_SIGNED_PERM_TYPE permanenceChange =
-                ifPreSynActive * VANILLA_SP_SYN_SIGNED_PERM_TYPE(VANILLA_SP_SYN_PERM_ACTIVE_INC) +
-                ifPreSynSilent * VANILLA_SP_SYN_SIGNED_PERM_TYPE(VANILLA_SP_SYN_PERM_INACTIVE_DEC);
-            *pPerm = _updatePermanence(permanenceValue, permanenceChange);
+        VANILLA_SP_SYN_SIGNED_PERM_TYPE ifPreSynActive = VANILLA_SP_SYN_SIGNED_PERM_TYPE(uPreSynCellValue);
+        VANILLA_SP_SYN_SIGNED_PERM_TYPE ifPreSynSilent = VANILLA_SP_SYN_SIGNED_PERM_TYPE(1) - ifPreSynActive;
+        VANILLA_SP_SYN_SIGNED_PERM_TYPE permanenceChange =
+            ifPreSynActive * VANILLA_SP_SYN_SIGNED_PERM_TYPE(VANILLA_SP_SYN_PERM_ACTIVE_INC) +
+            ifPreSynSilent * VANILLA_SP_SYN_SIGNED_PERM_TYPE(VANILLA_SP_SYN_PERM_INACTIVE_DEC);
+        *pPerm = _updatePermanence(permanenceValue, permanenceChange);
+#endif
+    }
 #endif
+#endif // VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8
+}
+
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_updateSynapsesOnActiveColumnsInParallel(const uint64* pInputBinaryBitmap,
+    const std::vector<uint16>& vecActiveIndices)
+{
+    const uint16* pActiveIndices = vecActiveIndices.data();
+    size_t uActiveCount = vecActiveIndices.size();
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // Each active column may record up to one index update per synapse: reserving that many slots per active column
+    _reserveDeferredIndexUpdates(uActiveCount);
+    uint32* pDeferredIndexUpdates = _pTmpDeferredIndexUpdates;
+    uint16* pDeferredIndexUpdatesCount = _pTmpDeferredIndexUpdatesCount;
+    HTMATCH::for_count(HTMATCH_PAR, 0u, u32fast(uActiveCount),
+            [this, pInputBinaryBitmap, pActiveIndices, pDeferredIndexUpdates, pDeferredIndexUpdatesCount](u32fast uActive) {
+        uint32* pStartUpdates = pDeferredIndexUpdates + size_t(uActive) * VANILLA_SP_MAX_SYNAPSES_PER_SEG;
+        uint32* pCurrentUpdate = pStartUpdates;
+        _updateSynapsesOnColumnTowardsCurrentInput(pInputBinaryBitmap, pActiveIndices[uActive], &pCurrentUpdate);
+        pDeferredIndexUpdatesCount[uActive] = uint16(pCurrentUpdate - pStartUpdates);
+    });
+    // Shared inverted index is then updated sequentially, in same order as the sequential path would, so that even the
+    //   order of the columns within each list stays the same
+    for (size_t uActive = 0u; uActive < uActiveCount; uActive++) {
+        _applyDeferredIndexUpdates(pActiveIndices[uActive], uActive);
+    }
+#else
+    // Each task only touches the segment and connectivity field of its own column
+    HTMATCH::for_count(HTMATCH_PAR, 0u, u32fast(uActiveCount),
+            [this, pInputBinaryBitmap, pActiveIndices](u32fast uActive) {
+        _updateSynapsesOnColumnTowardsCurrentInput(pInputBinaryBitmap, pActiveIndices[uActive], 0);
+    });
+#endif
+}
+
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_reserveDeferredIndexUpdates(size_t uColumnCount)
+{
+    if (uColumnCount > _uDeferredIndexUpdatesCapacity) {
+        delete[] _pTmpDeferredIndexUpdates;
+        delete[] _pTmpDeferredIndexUpdatesCount;
+        _uDeferredIndexUpdatesCapacity = std::max(uColumnCount, size_t(VANILLA_SP_MAX_WINNERS));
+        _pTmpDeferredIndexUpdates = new uint32[_uDeferredIndexUpdatesCapacity * VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+        _pTmpDeferredIndexUpdatesCount = new uint16[_uDeferredIndexUpdatesCapacity];
+    }
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_applyDeferredIndexUpdates(u16fast uColumnIndex, size_t uSlot)
+{
+    const uint32* pCurrentUpdate = _pTmpDeferredIndexUpdates + uSlot * VANILLA_SP_MAX_SYNAPSES_PER_SEG;
+    for (const uint32* pEndUpdate = pCurrentUpdate + _pTmpDeferredIndexUpdatesCount[uSlot]; pCurrentUpdate < pEndUpdate;
+            pCurrentUpdate++) {
+        u16fast uPreSynCellIndex = u16fast(*pCurrentUpdate >> 1u);
+        if (*pCurrentUpdate & 1u) {
+            _addToInvertedIndex(uColumnIndex, uPreSynCellIndex);
+        } else {
+            _removeFromInvertedIndex(uColumnIndex, uPreSynCellIndex);
         }
     }
 }
 
+#endif // VANILLA_SP_USE_SPARSE_INPUT_OPTI
+
+#endif // VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
-void VanillaSP::_onIncreasePermanencesForUnderUsedColums()
+void VanillaSP::_onMaintainUnderUsedColumns(u8fast uPeriodLog2, uint64 uBurstPhase)
+{
+    uint64 uPhase = _uEpoch & ((1uLL << uPeriodLog2) - 1uLL);
+    u16fast uFirstColumn = 0u;
+    u16fast uColumnCount = VANILLA_HTM_SHEET_2DSIZE;
+    if (_bUnderUsedColumnsBurstMode) {
+        if (uPhase != uBurstPhase)
+            return;
+    } else {
+        // Rotating slice: each column still gets visited once per period, but the cost gets spread over all steps
+        uColumnCount = u16fast(VANILLA_HTM_SHEET_2DSIZE >> uPeriodLog2);
+        uFirstColumn = u16fast(uPhase) * uColumnCount;
+    }
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    _materializeColumnUsage(_uEpochLearning + 1u, uFirstColumn, uColumnCount);  // (not yet increased for current step)
+#endif
+    _onIncreasePermanencesForUnderUsedColums(uFirstColumn, uColumnCount);
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_onIncreasePermanencesForUnderUsedColums(u16fast uFirstColumn, u16fast uColumnCount)
 {
-    u8fast uPotentialConnectivitySideSize = 1u + 2u * _uPotentialConnectivityRadius;
-    u32fast uSq = u32fast(uPotentialConnectivitySideSize) * u32fast(uPotentialConnectivitySideSize);
-    u32fast uTotalCount = uSq * u32fast(_uInputSheetsCount);
-    u32fast uConnectedCount = u32fast(std::round(float(uTotalCount) * _fPotentialConnectivityRatio));
-    u32fast uMaxCount = std::min(uTotalCount-u32fast(1u), u32fast(VANILLA_SP_MAX_SYNAPSES_PER_SEG));
     u16fast uRedrawCount = 0u;
     u16fast uSemiRedrawCount = 0u;
-    uConnectedCount = std::min(uMaxCount, uConnectedCount);
-    uConnectedCount = std::max(u32fast(1u), uConnectedCount);
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    if (_bParallelCompute) {
+        _onIncreasePermanencesForUnderUsedColumsInParallel(uFirstColumn, uColumnCount, &uRedrawCount, &uSemiRedrawCount);
+    } else
+#endif
+    {
+        for (u16fast uIndex = uFirstColumn; uIndex < uFirstColumn + uColumnCount; uIndex++) {
+            u8fast uRerolled = _onIncreasePermanencesForUnderUsedColumn(uIndex, 0);
+            uRedrawCount += u16fast(uRerolled & 1u);
+            uSemiRedrawCount += u16fast(uRerolled >> 1u);
+        }
+    }
+#if defined(VANILLA_SP_ALLOW_REROLLS) && defined(VANILLA_SP_USE_SPARSE_INPUT_OPTI)
+    // rerolls rewrote some connectivity fields (and potential pools) directly => inverted index needs a full rebuild
+    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
+        _rebuildInvertedIndex();
+#endif
+#ifdef VANILLA_SP_TRACE_STATS
+#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_GLOBAL_NOBOOSTING) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
+    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
+        std::cout << "*** global noboost had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
+#  endif
+#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_GLOBAL) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
+    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
+        std::cout << "*** global with boosting had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
+#  endif
+#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONLY) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
+    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
+        std::cout << "*** gaussian test had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
+#  endif
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+u8fast VanillaSP::_onIncreasePermanencesForUnderUsedColumn(u16fast uColumnIndex, uint32** ppDeferredIndexUpdates)
+{
+#ifndef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+    HTMATCH_unused(ppDeferredIndexUpdates);
+#endif
+    u8fast uRerolled = 0u;
+#if defined(VANILLA_SP_ALLOW_REROLLS) || (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+    Segment* pCurrentSegment = _pSegments + uColumnIndex;
+#endif
 #ifdef VANILLA_SP_ALLOW_REROLLS
-    uint16 pTmpBuffer[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+    u8fast uPotentialConnectivitySideSize = 1u + 2u * _uPotentialConnectivityRadius;
+    u32fast uSq = u32fast(uPotentialConnectivitySideSize) * u32fast(uPotentialConnectivitySideSize);
+    u32fast uTotalCount = uSq * u32fast(_uInputSheetsCount);
+    // one generator per column (hashing its index into the seed), for draws not to depend on column processing order
+    Rand synRand(uint32(_uEpoch), Rand::k_DefaultY + uint32(uColumnIndex),
+        Rand::k_DefaultZ ^ (uint32(uColumnIndex) * 2654435761u));
 #endif
-    Rand synRand;
-    synRand.seed(uint32(_uEpoch));
-    const float* pCurrentAverageOverThresholdRatio = _pAverageOverThresholdRatioPerColumn;
-    const float* pCurrentOverThresholdRatioTarget = _pOverThresholdRatioTargetPerColumn;
-    const float* pCurrentAverageActivation = _pAverageActiveRatioPerColumn;
-    uint32* pCurrentInactiveEpochs = _pInactiveEpochsPerColumn;
-    Segment* pCurrentSegment = _pSegments;
-    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentAverageOverThresholdRatio++,
-            pCurrentOverThresholdRatioTarget++, pCurrentAverageActivation++, pCurrentSegment++, pCurrentInactiveEpochs++) {
-        if (*pCurrentAverageOverThresholdRatio < *pCurrentOverThresholdRatioTarget) {
+    if (_pAverageOverThresholdRatioPerColumn[uColumnIndex] < _pOverThresholdRatioTargetPerColumn[uColumnIndex]) {
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+        // Bit-sliced permanences: increasing all potential synapses of that column at once, 64 of them at a time
+        _updatePermanencePlanes(0, uColumnIndex, VANILLA_SP_SYN_PERM_BELOW_STIM_INC, 0u, ppDeferredIndexUpdates);
+#  ifdef VANILLA_SP_ALLOW_REROLLS
+        u16fast uCount = pCurrentSegment->_uCount;
+        u16fast uConnectedCount = 0u;
+        const uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uColumnIndex;
+        for (size_t uQword = 0u; uQword < _uConnectivityFieldsQwordSizePerColumn; uQword++) {
+            uConnectedCount += u16fast(countSetBits64(pCurrentConnectivityField[uQword]));
+        }
+        u16fast uThreeQuartersMax = (3u * uCount) >> 2u;
+        if (uConnectedCount > uThreeQuartersMax) {
+            // same as below, yet only given one chance per call, as connected count is known for the whole column
+            float fRatioAbove = float(uConnectedCount - uThreeQuartersMax) * 4.0f / float(uCount);
+            if (synRand.getNextAsFloat01() < fRatioAbove) {
+                uRerolled = 1u;
+                u16fast uY = uColumnIndex & VANILLA_HTM_SHEET_YMASK;
+                u16fast uX = uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
+                VANILLA_SP_SYN_PERM_TYPE tDrawnPermValues[VANILLA_SP_MAX_SYNAPSES_PER_SEG];
+                uint16* pTmpBuffer = new uint16[uTotalCount];
+                _initMapPotentialsFullyLocal(*pCurrentSegment, uX, uY, &synRand, uPotentialConnectivitySideSize,
+                    _uInputSheetsCount, _uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                    tDrawnPermValues);
+                delete[] pTmpBuffer;
+                _initPermanencePlanes(uColumnIndex, tDrawnPermValues);
+                _initConnectivityField(uColumnIndex);
+            }
+        }
+#  endif
+#else
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-            uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uIndex;
-#endif
-            u16fast uCount = pCurrentSegment->_uCount;
-            u16fast uConnectedCount = 0u;
-            const uint16* pPreSyn = pCurrentSegment->_tPreSynIndex;
-            VANILLA_SP_SYN_PERM_TYPE* pPerm = pCurrentSegment->_tPermValue;
-            for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
-                VANILLA_SP_SYN_PERM_TYPE permanenceValue = *pPerm;
+        uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uColumnIndex;
+#endif
+        u16fast uCount = pCurrentSegment->_uCount;
+        u16fast uConnectedCount = 0u;
+        const uint16* pPreSyn = pCurrentSegment->_tPreSynIndex;
+        VANILLA_SP_SYN_PERM_TYPE* pPerm = pCurrentSegment->_tPermValue;
+        for (u16fast uSyn = 0u; uSyn < uCount; uSyn++, pPreSyn++, pPerm++) {
+            VANILLA_SP_SYN_PERM_TYPE permanenceValue = *pPerm;
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-                // If we're using connectivity field optimization,
-                //   then we need to add here to the connectivity bitfield whenever an unconnected synapse
-                //   becomes connected as a result of the increase applied to its permanence value.
-                if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
-                    permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
-                    if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
-                        u16fast uPreSynCellIndex = *pPreSyn;
-                        u16fast uPreSynCellQword = uPreSynCellIndex >> 6u;
-                        u16fast uPreSynCellBit = uPreSynCellIndex & 0x003Fu;
-                        uint64 uPreSynCellMask = 1uLL << uPreSynCellBit;
-                        pCurrentConnectivityField[uPreSynCellQword] |= uPreSynCellMask;
-                        uConnectedCount++;
-                    }
-                } else {
-                    permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
+            // If we're using connectivity field optimization,
+            //   then we need to add here to the connectivity bitfield whenever an unconnected synapse
+            //   becomes connected as a result of the increase applied to its permanence value.
+            if (permanenceValue < VANILLA_SP_SYN_CONNECTED_PERM) {
+                permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
+                if (permanenceValue >= VANILLA_SP_SYN_CONNECTED_PERM) {
+                    _connectSynapseInField(pCurrentConnectivityField, uColumnIndex, *pPreSyn, ppDeferredIndexUpdates);
                     uConnectedCount++;
                 }
-                *pPerm = permanenceValue;
+            } else {
+                permanenceValue = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
+                uConnectedCount++;
+            }
+            *pPerm = permanenceValue;
 #else  // !VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-                VANILLA_SP_SYN_PERM_TYPE permanence = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
-                *pPerm = permanence;
-                if (permanence = VANILLA_SP_SYN_CONNECTED_PERM) {
-                    uConnectedCount++;
-                }
+            VANILLA_SP_SYN_PERM_TYPE permanence = _increasePermanence(permanenceValue, VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
+            *pPerm = permanence;
+            if (permanence = VANILLA_SP_SYN_CONNECTED_PERM) {
+                uConnectedCount++;
+            }
 #endif
 #ifdef VANILLA_SP_ALLOW_REROLLS
-                u16fast uThreeQuartersMax = (3u * uCount) >> 2u;
-                if (uConnectedCount > uThreeQuartersMax) {
-                    // this cell already has 3/4 its potential as connected, and still languishes...
-                    float fRatioAbove = float(uConnectedCount - uThreeQuartersMax) * 4.0f / float(uCount);
-                    // it will get a chance to redraw its potential from scratch !
-                    if (synRand.getNextAsFloat01() < fRatioAbove) {
-                        uRedrawCount++;
-                        u16fast uY = uIndex & VANILLA_HTM_SHEET_YMASK;
-                        u16fast uX = uIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
-                        _initMapPotentialsFullyLocal(*pCurrentSegment, uX, uY, &synRand, uPotentialConnectivitySideSize,
-                            _uInputSheetsCount, _uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer);
+            u16fast uThreeQuartersMax = (3u * uCount) >> 2u;
+            if (uConnectedCount > uThreeQuartersMax) {
+                // this cell already has 3/4 its potential as connected, and still languishes...
+                float fRatioAbove = float(uConnectedCount - uThreeQuartersMax) * 4.0f / float(uCount);
+                // it will get a chance to redraw its potential from scratch !
+                if (synRand.getNextAsFloat01() < fRatioAbove) {
+                    uRerolled = 1u;
+                    u16fast uY = uColumnIndex & VANILLA_HTM_SHEET_YMASK;
+                    u16fast uX = uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
+                    uint16* pTmpBuffer = new uint16[uTotalCount];
+                    _initMapPotentialsFullyLocal(*pCurrentSegment, uX, uY, &synRand, uPotentialConnectivitySideSize,
+                        _uInputSheetsCount, _uPotentialConnectivityRadius, uTotalCount, u16fast(uConnectedCount), pTmpBuffer,
+                        pCurrentSegment->_tPermValue);
+                    delete[] pTmpBuffer;
 #ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-                        _initConnectivityField(*pCurrentSegment, pCurrentConnectivityField, _uInputSheetsCount);
+                    _initConnectivityField(uColumnIndex);
 #endif
-                    }
                 }
-#endif
             }
-        } 
+#endif
+        }
+#endif // VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8
+    } 
 #ifdef VANILLA_SP_ALLOW_REROLLS
-        else {
-            uint32 uInactiveEpochCount = *pCurrentInactiveEpochs; 
-            if (uInactiveEpochCount > 200u && *pCurrentAverageActivation < 0.75f * _fActivationDensityRatio) {
-                uint32 uInactiveEpochOver200 = uInactiveEpochCount-200u;
-                if (uInactiveEpochOver200 > (synRand.getNext() & 0x00000FFFu)) {
-                    uSemiRedrawCount++;
-                    uint16* pCurrent = pTmpBuffer;
-                    u16fast uStartZIndex = 0u;
-                    u16fast uY = uIndex & VANILLA_HTM_SHEET_YMASK;
-                    u16fast uX = uIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
-                    for (u16fast uCandidateZ = 0u; uCandidateZ < _uInputSheetsCount; uCandidateZ++, uStartZIndex += VANILLA_HTM_SHEET_2DSIZE) {
-                        for (u16fast uCandidateRelX = 0u; uCandidateRelX < uPotentialConnectivitySideSize; uCandidateRelX++) {
-                            u16fast uCandidateX = u16fast(uX - _uPotentialConnectivityRadius + uCandidateRelX) & VANILLA_HTM_SHEET_XMASK;
-                            u16fast uStartXIndex = uStartZIndex + (uCandidateX << VANILLA_HTM_SHEET_SHIFT_DIVY);
-                            for (u16fast uCandidateRelY = 0u; uCandidateRelY < uPotentialConnectivitySideSize; uCandidateRelY++, pCurrent++) {
-                                u16fast uCandidateY = u16fast(uY - _uPotentialConnectivityRadius + uCandidateRelY) & VANILLA_HTM_SHEET_YMASK;
-                                *pCurrent = uint16(uStartXIndex + uCandidateY);
-                            }
+    else {
+        uint32 uInactiveEpochCount = _pInactiveEpochsPerColumn[uColumnIndex];
+        if (uInactiveEpochCount > 200u && _pAverageActiveRatioPerColumn[uColumnIndex] < 0.75f * _fActivationDensityRatio) {
+            uint32 uInactiveEpochOver200 = uInactiveEpochCount-200u;
+            if (uInactiveEpochOver200 > (synRand.getNext() & 0x00000FFFu)) {
+                uRerolled = 2u;
+                uint16* pTmpBuffer = new uint16[uTotalCount];
+                uint16* pCurrent = pTmpBuffer;
+                u16fast uStartZIndex = 0u;
+                u16fast uY = uColumnIndex & VANILLA_HTM_SHEET_YMASK;
+                u16fast uX = uColumnIndex >> VANILLA_HTM_SHEET_SHIFT_DIVY;
+                for (u16fast uCandidateZ = 0u; uCandidateZ < _uInputSheetsCount; uCandidateZ++, uStartZIndex += VANILLA_HTM_SHEET_2DSIZE) {
+                    for (u16fast uCandidateRelX = 0u; uCandidateRelX < uPotentialConnectivitySideSize; uCandidateRelX++) {
+                        u16fast uCandidateX = u16fast(uX - _uPotentialConnectivityRadius + uCandidateRelX) & VANILLA_HTM_SHEET_XMASK;
+                        u16fast uStartXIndex = uStartZIndex + (uCandidateX << VANILLA_HTM_SHEET_SHIFT_DIVY);
+                        for (u16fast uCandidateRelY = 0u; uCandidateRelY < uPotentialConnectivitySideSize; uCandidateRelY++, pCurrent++) {
+                            u16fast uCandidateY = u16fast(uY - _uPotentialConnectivityRadius + uCandidateRelY) & VANILLA_HTM_SHEET_YMASK;
+                            *pCurrent = uint16(uStartXIndex + uCandidateY);
                         }
                     }
-#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-                    uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uIndex;
-#endif
-                    // randomly change between 5 and 20 synapses
-                    uint32 uSynapsesToSwitch = 5u + (synRand.getNext() & 0x0000000Fu);
-                    uint32 uRemaining = uTotalCount;
-                    for (uint32 uSyn = 0u; uSyn < uSynapsesToSwitch; uSyn++) {
-                        uint32 uPosToChange = synRand.getNext() % pCurrentSegment->_uCount;
-                        uint32 uChangedIndex = pCurrentSegment->_tPreSynIndex[uPosToChange];
-                        uint32 uNewIndex = synRand.getNext() % uRemaining;
-                        uRemaining--;
-                        pCurrentSegment->_tPreSynIndex[uPosToChange] = uChangedIndex;
-                        pCurrentSegment->_tPermValue[uPosToChange] = VANILLA_SP_SYN_CONNECTED_PERM + VANILLA_SP_SYN_PERM_BELOW_STIM_INC;
-#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
-                        u16fast uOldQword = uChangedIndex >> 6u;
-                        u16fast uOldBit = uChangedIndex & 0x003Fu;
+                }
+                delete[] pTmpBuffer;
+#if defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI) && (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                uint64* pCurrentConnectivityField = _pConnectivityFields + _uConnectivityFieldsQwordSizePerColumn * uColumnIndex;
+#endif
+                // randomly change between 5 and 20 synapses
+                uint32 uSynapsesToSwitch = 5u + (synRand.getNext() & 0x0000000Fu);
+                uint32 uRemaining = uTotalCount;
+                for (uint32 uSyn = 0u; uSyn < uSynapsesToSwitch; uSyn++) {
+                    uint32 uPosToChange = synRand.getNext() % pCurrentSegment->_uCount;
+                    uint32 uChangedIndex = pCurrentSegment->_tPreSynIndex[uPosToChange];
+                    uint32 uNewIndex = synRand.getNext() % uRemaining;
+                    uRemaining--;
+                    pCurrentSegment->_tPreSynIndex[uPosToChange] = uChangedIndex;
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                    // (connectivity field then rebuilt from the bitplanes as a whole, below)
+                    HTMATCH_unused(uNewIndex);
+                    _setPermanenceInPlanes(uColumnIndex, uChangedIndex,
+                        VANILLA_SP_SYN_CONNECTED_PERM + VANILLA_SP_SYN_PERM_BELOW_STIM_INC);
+#else
+                    pCurrentSegment->_tPermValue[uPosToChange] = VANILLA_SP_SYN_CONNECTED_PERM + VANILLA_SP_SYN_PERM_BELOW_STIM_INC;
+#endif
+#if defined(VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI) && (VANILLA_SP_SYNAPSE_KIND != VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                    // (cells falling outside of a windowed field cannot be represented there => ignored)
+                    size_t uOldQword = _getConnectivityFieldQwordPos(uColumnIndex, uChangedIndex);
+                    u16fast uOldBit = uChangedIndex & 0x003Fu;
+                    if (uOldQword < _uConnectivityFieldsQwordSizePerColumn)
                         pCurrentConnectivityField[uOldQword] &= ~(1uLL << uOldBit);
-                        u16fast uNewQword = uNewIndex >> 6u;
-                        u16fast uNewBit = uNewIndex & 0x003Fu;
+                    size_t uNewQword = _getConnectivityFieldQwordPos(uColumnIndex, uNewIndex);
+                    u16fast uNewBit = uNewIndex & 0x003Fu;
+                    if (uNewQword < _uConnectivityFieldsQwordSizePerColumn)
                         pCurrentConnectivityField[uNewQword] |= (1uLL << uNewBit);
 #endif
-                    }
                 }
+#if (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_BITSLICED8)
+                _initConnectivityField(uColumnIndex);
+#endif
             }
         }
+    }
 #endif
+    return uRerolled;
+}
+
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_onIncreasePermanencesForUnderUsedColumsInParallel(u16fast uFirstColumn, u16fast uColumnCount,
+    u16fast* pRedrawCount, u16fast* pSemiRedrawCount)
+{
+    uint8 tRerolled[VANILLA_HTM_SHEET_2DSIZE];
+    uint8* pRerolled = tRerolled;
+#ifdef VANILLA_SP_USE_SPARSE_INPUT_OPTI
+    // Each column may record up to one index update per synapse: processing as many columns at once as the deferred
+    //   buffers can hold, then applying their updates in column order, as the sequential path would
+    _reserveDeferredIndexUpdates(size_t(VANILLA_SP_MAX_WINNERS));
+    u32fast uBatchSize = u32fast(std::min(_uDeferredIndexUpdatesCapacity, size_t(uColumnCount)));
+    uint32* pDeferredIndexUpdates = _pTmpDeferredIndexUpdates;
+    uint16* pDeferredIndexUpdatesCount = _pTmpDeferredIndexUpdatesCount;
+    for (u32fast uBatchStart = 0u; uBatchStart < uColumnCount; uBatchStart += uBatchSize) {
+        u32fast uBatchCount = std::min(uBatchSize, u32fast(uColumnCount) - uBatchStart);
+        HTMATCH::for_count(HTMATCH_PAR, 0u, uBatchCount,
+                [this, uFirstColumn, uBatchStart, pRerolled, pDeferredIndexUpdates, pDeferredIndexUpdatesCount](u32fast uSlot) {
+            uint32* pStartUpdates = pDeferredIndexUpdates + size_t(uSlot) * VANILLA_SP_MAX_SYNAPSES_PER_SEG;
+            uint32* pCurrentUpdate = pStartUpdates;
+            pRerolled[uBatchStart + uSlot] = uint8(_onIncreasePermanencesForUnderUsedColumn(
+                u16fast(uFirstColumn + uBatchStart + uSlot), &pCurrentUpdate));
+            pDeferredIndexUpdatesCount[uSlot] = uint16(pCurrentUpdate - pStartUpdates);
+        });
+        for (u32fast uSlot = 0u; uSlot < uBatchCount; uSlot++) {
+            _applyDeferredIndexUpdates(u16fast(uFirstColumn + uBatchStart + uSlot), uSlot);
+        }
     }
-#ifdef VANILLA_SP_TRACE_STATS
-#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_GLOBAL_NOBOOSTING) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
-    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
-        std::cout << "*** global noboost had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
-#  endif
-#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_GLOBAL) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
-    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
-        std::cout << "*** global with boosting had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
-#  endif
-#  if (VANILLA_SP_CONFIG == VANILLA_SP_CONFIG_CONST_LOCAL_GAUSS_ONLY) && (VANILLA_SP_SYNAPSE_KIND == VANILLA_SP_SYNAPSE_KIND_CONST_USE_FLOAT32)
-    if (uRedrawCount > 0 || uSemiRedrawCount > 0)
-        std::cout << "*** gaussian test had " << uRedrawCount << " columns fully redrawn and " << uSemiRedrawCount << " partial" << std::endl;
-#  endif
+#else
+    // Each task only touches the segment and connectivity field of its own column
+    HTMATCH::for_count(HTMATCH_PAR, 0u, uColumnCount, [this, uFirstColumn, pRerolled](u32fast uSlot) {
+        pRerolled[uSlot] = uint8(_onIncreasePermanencesForUnderUsedColumn(u16fast(uFirstColumn + uSlot), 0));
+    });
 #endif
+    for (u16fast uSlot = 0u; uSlot < uColumnCount; uSlot++) {
+        *pRedrawCount += u16fast(tRerolled[uSlot] & 1u);
+        *pSemiRedrawCount += u16fast(tRerolled[uSlot] >> 1u);
+    }
 }
 
+#endif // VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::_onEvaluateColumnUsage(const uint16* pRawActivationLevelsPerCol, const uint64* pResultingBinaryBitmap)
 {
-    memset((void*)_pTmpBinaryOverThresholdActivations, 0, VANILLA_HTM_SHEET_BYTES_BINARY);
-    const uint16* pCurrentRawActivationLevel = pRawActivationLevelsPerCol;
-    for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentRawActivationLevel++) {
-        if (*pCurrentRawActivationLevel >= VANILLA_SP_DEFAULT_STIMULUS_THRESHOLD) {
-            u16fast uQword = uIndex >> 6u;
-            u16fast uBit = uIndex & 0x003Fu;
-            _pTmpBinaryOverThresholdActivations[uQword] |= (1uLL << uBit);
-        }
+    // (at or above stimulus threshold being strictly above threshold minus one, 32 columns at a time)
+    const uint16* pCurrentRawActivationLevels = pRawActivationLevelsPerCol;
+    for (size_t uQword = 0u; uQword < (VANILLA_HTM_SHEET_2DSIZE >> 6u); uQword++, pCurrentRawActivationLevels += 64u) {
+        uint64 uLowHalf = _pMaskAbove16Func(pCurrentRawActivationLevels, 32u, VANILLA_SP_DEFAULT_STIMULUS_THRESHOLD - 1u);
+        uint64 uHighHalf = _pMaskAbove16Func(pCurrentRawActivationLevels + 32u, 32u, VANILLA_SP_DEFAULT_STIMULUS_THRESHOLD - 1u);
+        _pTmpBinaryOverThresholdActivations[uQword] = uLowHalf | (uHighHalf << 32u);
     }
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+    _integrateBinaryFieldToMovingAveragesLazily(_pAverageOverThresholdRatioPerColumn, _pOverThresholdRatioEpochPerColumn,
+        _pTmpBinaryOverThresholdActivations, _uEpochLearning, _uColumnUsageIntegrationWindow);
+    _integrateBinaryFieldToMovingAveragesLazily(_pAverageActiveRatioPerColumn, _pActiveRatioEpochPerColumn,
+        pResultingBinaryBitmap, _uEpochLearning, _uColumnUsageIntegrationWindow);
+#else
     _integrateBinaryFieldToMovingAverages(_pAverageOverThresholdRatioPerColumn, _pTmpBinaryOverThresholdActivations,
         std::min(_uColumnUsageIntegrationWindow, _uEpochLearning+1u));
     _integrateBinaryFieldToMovingAverages(_pAverageActiveRatioPerColumn, pResultingBinaryBitmap,
         std::min(_uColumnUsageIntegrationWindow, _uEpochLearning+1u));
+#endif
 #ifdef VANILLA_SP_ALLOW_REROLLS
     uint32* pCurrentInactivity = _pInactiveEpochsPerColumn;
     for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentInactivity++) {
@@ -2178,6 +4217,18 @@ void VanillaSP::_onEvaluateColumnUsage(const uint16* pRawActivationLevelsPerCol,
 #endif
 }
 
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+// - - - - - - - - - - - - - - - - - - - -
+// - - - - - - - - - - - - - - - - - - - -
+void VanillaSP::_materializeColumnUsage(uint64 uEpoch, u16fast uFirstColumn, u16fast uColumnCount)
+{
+    _catchUpMovingAverages(_pAverageOverThresholdRatioPerColumn, _pOverThresholdRatioEpochPerColumn, uEpoch,
+        _uColumnUsageIntegrationWindow, size_t(uFirstColumn), size_t(uColumnCount));
+    _catchUpMovingAverages(_pAverageActiveRatioPerColumn, _pActiveRatioEpochPerColumn, uEpoch,
+        _uColumnUsageIntegrationWindow, size_t(uFirstColumn), size_t(uColumnCount));
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - -
 // - - - - - - - - - - - - - - - - - - - -
 void VanillaSP::getAverageActivationStats(float fUltraLowValue, uint16* outUltraLowCount, float fUltraHighValue, uint16* outUltraHighCount,
@@ -2191,6 +4242,12 @@ void VanillaSP::getAverageActivationStats(float fUltraLowValue, uint16* outUltra
     const float* pCurrentActivation = _pAverageActiveRatioPerColumn;
     for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentActivation++) {
         float fCurrentActivation = *pCurrentActivation;
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+        // (stored average may lag behind: applying the decay it missed, yet without storing it, as we're const)
+        if (_pActiveRatioEpochPerColumn[uIndex] < _uEpochLearning)
+            fCurrentActivation *= _getMovingAverageDecay(_pActiveRatioEpochPerColumn[uIndex], _uEpochLearning,
+                _uColumnUsageIntegrationWindow);
+#endif
         if (fCurrentActivation < fUltraLowValue)
             uLowCount++;
         if (outUltraHighCount && fCurrentActivation > fUltraHighValue)
@@ -2213,6 +4270,11 @@ void VanillaSP::getAverageActivationStats(float fUltraLowValue, uint16* outUltra
         pCurrentActivation = _pAverageActiveRatioPerColumn;
         for (u16fast uIndex = 0u; uIndex < VANILLA_HTM_SHEET_2DSIZE; uIndex++, pCurrentActivation++) {
             float fCurrentActivation = *pCurrentActivation;
+#ifdef VANILLA_SP_USE_LAZY_COLUMN_USAGE
+            if (_pActiveRatioEpochPerColumn[uIndex] < _uEpochLearning)
+                fCurrentActivation *= _getMovingAverageDecay(_pActiveRatioEpochPerColumn[uIndex], _uEpochLearning,
+                    _uColumnUsageIntegrationWindow);
+#endif
             float fDiffToAvg = (fCurrentActivation - fAverage);
             fVarSum += fDiffToAvg * fDiffToAvg;
         }
@@ -2243,6 +4305,101 @@ void VanillaSP::getAverageActivationStats(float fUltraLowValue, uint16* outUltra
 }
 
 
+#ifdef VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP ctor
+// - - - - - - - - - - - - - - - - - - - -
+FrozenVanillaSP::FrozenVanillaSP(const VanillaSP& trainedSP)
+{
+    // copying all inference state at once (connectivity parameters, inhibition parameters and current K)...
+    VanillaSPInferenceCore::operator=(trainedSP);
+#ifdef VANILLA_SP_ALLOW_PARALLEL_COMPUTE
+    _bParallelCompute = false;      // each thread serving us rather brings its own context
+#endif
+    // ...then getting our own copies of the tables instead of pointing to the ones of 'trainedSP'
+    size_t uFieldsQwordCount = VANILLA_HTM_SHEET_2DSIZE * _uConnectivityFieldsQwordSizePerColumn;
+    _pConnectivityFields = new uint64[uFieldsQwordCount];
+    memcpy((void*)_pConnectivityFields, trainedSP._pConnectivityFields, uFieldsQwordCount * sizeof(uint64));
+#ifdef VANILLA_SP_USE_BOOSTING
+    _pBoostingPerCol = new uint16[VANILLA_HTM_SHEET_2DSIZE];
+    memcpy((void*)_pBoostingPerCol, trainedSP._pBoostingPerCol, VANILLA_HTM_SHEET_2DSIZE * sizeof(uint16));
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP dtor
+// - - - - - - - - - - - - - - - - - - - -
+FrozenVanillaSP::~FrozenVanillaSP()
+{
+    delete[] _pConnectivityFields;
+#ifdef VANILLA_SP_USE_BOOSTING
+    delete[] _pBoostingPerCol;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP::Context ctor
+// - - - - - - - - - - - - - - - - - - - -
+FrozenVanillaSP::Context::Context(const FrozenVanillaSP& frozenSP)
+    : _scratch(frozenSP._uInputQwordCount)
+{
+    static const size_t uQwordsPerBinarySheet = VANILLA_HTM_SHEET_2DSIZE >> 6u;  // 64b per Qword
+    _pTmpBinaryInputBuffer = new uint64[frozenSP._uInputQwordCount];
+    _pTmpBinaryOutputBuffer = new uint64[uQwordsPerBinarySheet];
+    _pTmpRawActivationLevelsPerCol = new uint16[VANILLA_HTM_SHEET_2DSIZE];
+#ifdef VANILLA_SP_USE_BOOSTING
+    _pTmpBoostedActivationLevelsPerCol = new uint32[VANILLA_HTM_SHEET_2DSIZE];
+#endif
+    _vecTmpOutputIndices.reserve(VANILLA_HTM_SHEET_2DSIZE);    // can't ever need more => no reallocation past this point
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP::Context dtor
+// - - - - - - - - - - - - - - - - - - - -
+FrozenVanillaSP::Context::~Context()
+{
+    delete[] _pTmpBinaryInputBuffer;
+    delete[] _pTmpBinaryOutputBuffer;
+    delete[] _pTmpRawActivationLevelsPerCol;
+#ifdef VANILLA_SP_USE_BOOSTING
+    delete[] _pTmpBoostedActivationLevelsPerCol;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - -
+// FrozenVanillaSP main '_compute' method
+// - - - - - - - - - - - - - - - - - - - -
+void FrozenVanillaSP::_compute(Context& context, const uint64* pInputBinaryBitmap, std::vector<uint16>& vecOutputIndices,
+    uint64* pOutputBinaryBitmap, uint32* pOutputMinActivations) const
+{
+    vecOutputIndices.clear();
+    VanillaSPScratch& scratch = context._scratch;
+    // same choice between dense and gathered kernels as VanillaSP::_computeUnrestrictedActivationLevels(). There is no
+    //   inverted index here (not to double the memory footprint of connectivity), but raw activation levels are the same.
+    uint64 uActiveInputCount = 0uLL;
+    size_t uActiveQwordCount = _compactNonZeroQwords(pInputBinaryBitmap, _uInputQwordCount,
+        scratch._pTmpActiveInputQwordOffsets, scratch._pTmpActiveInputQwordValues, &uActiveInputCount);
+    bool bGatherActiveQwords = uActiveQwordCount * size_t(VANILLA_SP_GATHERED_INPUT_COST_RATIO) < _uInputQwordCount;
+    _computeUnrestrictedActivationLevelsOnColumnRange(pInputBinaryBitmap, scratch._pTmpActiveInputQwordOffsets,
+        scratch._pTmpActiveInputQwordValues, uActiveQwordCount, bGatherActiveQwords, 0u, VANILLA_HTM_SHEET_2DSIZE,
+        context._pTmpRawActivationLevelsPerCol);
+    if (!pOutputBinaryBitmap)
+        pOutputBinaryBitmap = context._pTmpBinaryOutputBuffer;
+#ifdef VANILLA_SP_USE_BOOSTING
+    _applyBoostFactors(context._pTmpRawActivationLevelsPerCol, _pBoostingPerCol, VANILLA_HTM_SHEET_2DSIZE,
+        context._pTmpBoostedActivationLevelsPerCol);
+    _getActiveColumnsFromActivationLevels(context._pTmpBoostedActivationLevelsPerCol, vecOutputIndices,
+        pOutputBinaryBitmap, pOutputMinActivations, scratch);
+#else
+    _getActiveColumnsFromActivationLevels(context._pTmpRawActivationLevelsPerCol, vecOutputIndices,
+        pOutputBinaryBitmap, pOutputMinActivations, scratch);
+#endif
+}
+
+#endif // VANILLA_SP_USE_CONNECTIVITY_FIELD_OPTI
+
+
 #if defined(VANILLA_SP_SUBNAMESPACE)
     } // namespace VANILLA_SP_SUBNAMESPACE
 #endif